@@ -1,19 +1,33 @@
 #ifndef BIG_INTEGER_H
 #define BIG_INTEGER_H
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <gmp.h>
 #include <iosfwd>
+#include <random>
+#include <vector>
+
+template<size_t Bits, bool Signed>
+struct fixed_integer;
+
+struct big_integer_access;
 
 struct big_integer
 {
     big_integer();
     big_integer(big_integer const& other);
+    big_integer(big_integer&& other) noexcept;
     big_integer(int a);
     explicit big_integer(std::string const& str);
     ~big_integer();
 
     big_integer& operator=(big_integer const& other);
+    big_integer& operator=(big_integer&& other) noexcept;
+
+    void swap(big_integer& other);
 
     big_integer& operator+=(big_integer const& rhs);
     big_integer& operator-=(big_integer const& rhs);
@@ -25,8 +39,8 @@ struct big_integer
     big_integer& operator|=(big_integer const& rhs);
     big_integer& operator^=(big_integer const& rhs);
 
-    big_integer& operator<<=(int rhs);
-    big_integer& operator>>=(int rhs);
+    big_integer& operator<<=(uint64_t rhs);
+    big_integer& operator>>=(uint64_t rhs);
 
     big_integer operator+() const;
     big_integer operator-() const;
@@ -47,10 +61,117 @@ struct big_integer
 
     friend std::string to_string(big_integer const& a);
 
+    // Bit queries and updates follow the infinite two's complement form used by
+    // the bitwise operators, except that bit_length, popcount and
+    // count_trailing_zeros describe the magnitude (all three are 0 for zero).
+    static uint64_t const npos = ~uint64_t(0);
+
+    uint64_t bit_length() const;
+    uint64_t popcount() const;
+    uint64_t count_trailing_zeros() const;
+
+    bool test_bit(uint64_t i) const;
+    void set_bit(uint64_t i);
+    void clear_bit(uint64_t i);
+    void flip_bit(uint64_t i);
+
+    // index of the first 1 (0) bit at or after `from`, npos if there is none
+    uint64_t scan1(uint64_t from) const;
+    uint64_t scan0(uint64_t from) const;
+
+    // mixes the limbs and the sign, equal values hash equally; the result is cached
+    // until the next mutation, so repeated lookups with one key cost O(1)
+    size_t hash() const;
+
+    // Uniform random values drawn straight into the limbs, one generator word per
+    // limb (several for generators narrower than 64 bits). random_bits yields
+    // [0, 2^bits), random_below [0, bound) and throws std::invalid_argument for a
+    // non-positive bound. The vector overload resizes values to count and fills
+    // every element with random_bits, reusing the existing elements' buffers.
+    template<typename URBG>
+    static big_integer random_bits(uint64_t bits, URBG& g);
+    template<typename URBG>
+    static big_integer random_below(big_integer const& bound, URBG& g);
+    template<typename URBG>
+    static void random_bits(std::vector<big_integer>& values, size_t count, uint64_t bits, URBG& g);
+
+    // upper bound on threads used by a single operation on very large operands,
+    // 1 keeps everything on the calling thread
+    static void set_concurrency(size_t threads);
+    static size_t concurrency();
+
 private:
+    template<size_t Bits, bool Signed>
+    friend struct fixed_integer;
+    friend struct big_integer_access;
+
+    template<typename URBG>
+    void assign_random_bits(uint64_t bits, URBG& g);
+    mp_limb_t* random_limbs(uint64_t bits);
+    void finish_random(mp_limb_t* limbs, uint64_t bits);
+    static void check_random_bound(big_integer const& bound);
+
+    void invalidate_hash()
+    {
+        hash_.store(0, std::memory_order_relaxed);
+    }
+
     mpz_t mpz;
+    // 0 while unknown; atomic because const lookups may share a key across threads
+    mutable std::atomic<size_t> hash_;
 };
 
+template<typename URBG>
+void big_integer::assign_random_bits(uint64_t bits, URBG& g)
+{
+    std::uniform_int_distribution<mp_limb_t> limb;
+    mp_limb_t* limbs = random_limbs(bits);
+    for (uint64_t i = 0, n = (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS; i != n; i++)
+    {
+        limbs[i] = limb(g);
+    }
+    finish_random(limbs, bits);
+}
+
+template<typename URBG>
+big_integer big_integer::random_bits(uint64_t bits, URBG& g)
+{
+    big_integer r;
+    r.assign_random_bits(bits, g);
+    return r;
+}
+
+template<typename URBG>
+big_integer big_integer::random_below(big_integer const& bound, URBG& g)
+{
+    check_random_bound(bound);
+    // fewer than two tries on average, each at least halves the chance to retry
+    uint64_t bits = bound.bit_length();
+    big_integer r;
+    do
+    {
+        r.assign_random_bits(bits, g);
+    }
+    while (r >= bound);
+    return r;
+}
+
+template<typename URBG>
+void big_integer::random_bits(std::vector<big_integer>& values, size_t count, uint64_t bits, URBG& g)
+{
+    if (values.capacity() < count)
+    {
+        values.clear();
+    }
+    values.resize(count);
+    for (big_integer& value : values)
+    {
+        value.assign_random_bits(bits, g);
+    }
+}
+
+void swap(big_integer& a, big_integer& b);
+
 big_integer operator+(big_integer a, big_integer const& b);
 big_integer operator-(big_integer a, big_integer const& b);
 big_integer operator*(big_integer a, big_integer const& b);
@@ -61,8 +182,8 @@ big_integer operator&(big_integer a, big_integer const& b);
 big_integer operator|(big_integer a, big_integer const& b);
 big_integer operator^(big_integer a, big_integer const& b);
 
-big_integer operator<<(big_integer a, int b);
-big_integer operator>>(big_integer a, int b);
+big_integer operator<<(big_integer a, uint64_t b);
+big_integer operator>>(big_integer a, uint64_t b);
 
 bool operator==(big_integer const& a, big_integer const& b);
 bool operator!=(big_integer const& a, big_integer const& b);
@@ -74,4 +195,16 @@ bool operator>=(big_integer const& a, big_integer const& b);
 std::string to_string(big_integer const& a);
 std::ostream& operator<<(std::ostream& s, big_integer const& a);
 
+namespace std
+{
+template<>
+struct hash<big_integer>
+{
+    size_t operator()(big_integer const& a) const
+    {
+        return a.hash();
+    }
+};
+}
+
 #endif // BIG_INTEGER_H
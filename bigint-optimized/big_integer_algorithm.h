@@ -0,0 +1,67 @@
+#ifndef BIG_INTEGER_ALGORITHM_H
+#define BIG_INTEGER_ALGORITHM_H
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "big_integer.h"
+
+namespace big_integer_detail
+{
+big_integer product(std::vector<big_integer> values);
+big_integer product(std::vector<int64_t> const& words);
+big_integer product(std::vector<uint64_t> const& words);
+
+big_integer sum(std::vector<big_integer> values);
+big_integer sum(std::vector<int64_t> const& words);
+big_integer sum(std::vector<uint64_t> const& words);
+
+// the segmented sieve behind factorial, binomial and primorial, uncached and with
+// a chosen segment size, so that tests can make the base primes outgrow it
+std::vector<uint32_t> primes(uint64_t n, size_t segment);
+
+// signed words become int64_t, unsigned ones uint64_t, anything else big_integer
+template<typename T, bool = std::is_integral<T>::value>
+struct leaf
+{
+    typedef big_integer type;
+};
+
+template<typename T>
+struct leaf<T, true>
+{
+    typedef typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type type;
+};
+
+template<typename InputIt>
+using leaves = std::vector<typename leaf<typename std::iterator_traits<InputIt>::value_type>::type>;
+}
+
+// Product (1 for an empty range) and sum (0 for an empty range) of big_integers or
+// machine words. Operands are combined along a balanced binary tree, so every
+// multiplication is between numbers of similar size and the work is O(M(n) log n)
+// instead of the quadratic left-to-right loop; the pairs of a tree level are
+// spread over big_integer::concurrency() threads once the level is large enough.
+template<typename InputIt>
+big_integer product(InputIt first, InputIt last)
+{
+    return big_integer_detail::product(big_integer_detail::leaves<InputIt>(first, last));
+}
+
+template<typename InputIt>
+big_integer sum(InputIt first, InputIt last)
+{
+    return big_integer_detail::sum(big_integer_detail::leaves<InputIt>(first, last));
+}
+
+// n!, C(n, k) (0 for k > n) and the product of all primes <= n. Each result is
+// built from its prime factorization (prime swing for the factorial) and one
+// product tree; the primes come from a segmented sieve shared by all three.
+// Throws std::length_error for n >= 2^32.
+big_integer factorial(uint64_t n);
+big_integer binomial(uint64_t n, uint64_t k);
+big_integer primorial(uint64_t n);
+
+#endif // BIG_INTEGER_ALGORITHM_H
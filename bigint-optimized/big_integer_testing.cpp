@@ -2,12 +2,20 @@
 #include <cassert>
 #include <cstdlib>
 #include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
+#include "big_integer_algorithm.h"
+#include "big_integer_stats.h"
+#include "big_integer_thresholds.h"
 #include "big_integer_gmp.h"
+#include "fixed_integer.h"
+#include "limb_kernels.h"
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -690,6 +698,284 @@ TEST(correctness, div_randomized) {
   }
 }
 
+TEST(correctness, mul_parallel) {
+  std::default_random_engine rng(7);
+  size_t const limb_bits = 64;
+  std::pair<size_t, size_t> const shapes[] = {{6000, 5000}, {30000, 4500}, {9000, 8999}};
+  size_t concurrency = big_integer::concurrency();
+  for (auto const& shape : shapes) {
+    big_integer_gmp a, b;
+    a.random(shape.first * limb_bits, rng);
+    b.random(shape.second * limb_bits, rng);
+    big_integer A(to_string(a)), B(to_string(b));
+
+    big_integer::set_concurrency(1);
+    big_integer serial = A * B;
+    for (size_t threads : {2, 3, 8}) {
+      big_integer::set_concurrency(threads);
+      EXPECT_EQ(serial, A * B);
+      EXPECT_EQ(-serial, -A * B);
+    }
+    EXPECT_EQ(to_string(a * b), to_string(serial));
+  }
+  big_integer::set_concurrency(concurrency);
+}
+
+TEST(correctness, product_and_sum) {
+  EXPECT_EQ(1, product(static_cast<big_integer*>(nullptr), static_cast<big_integer*>(nullptr)));
+  EXPECT_EQ(0, sum(static_cast<int*>(nullptr), static_cast<int*>(nullptr)));
+
+  std::default_random_engine rng(13);
+  size_t concurrency = big_integer::concurrency();
+  for (size_t n : {1, 2, 3, 7, 64, 1000}) {
+    std::vector<big_integer> values;
+    std::vector<int64_t> words;
+    std::vector<uint64_t> uwords;
+    for (size_t i = 0; i != n; ++i) {
+      big_integer_gmp g;
+      g.random(rng() % 2000, rng);
+      values.emplace_back(to_string(g));
+      if (rng() % 3 == 0)
+        values.back() = -values.back();
+      words.push_back(static_cast<int64_t>(rng() * 2654435761u) - (1ll << 62));
+      uwords.push_back(~uint64_t(0) - rng());
+    }
+
+    big_integer p = 1, s, pw = 1, sw, pu = 1, su;
+    for (size_t i = 0; i != n; ++i) {
+      p *= values[i];
+      s += values[i];
+      big_integer w(std::to_string(words[i])), u(std::to_string(uwords[i]));
+      pw *= w;
+      sw += w;
+      pu *= u;
+      su += u;
+    }
+    for (size_t threads : {1, 4}) {
+      big_integer::set_concurrency(threads);
+      EXPECT_EQ(p, product(values.begin(), values.end()));
+      EXPECT_EQ(s, sum(values.begin(), values.end()));
+      EXPECT_EQ(pw, product(words.begin(), words.end()));
+      EXPECT_EQ(sw, sum(words.begin(), words.end()));
+      EXPECT_EQ(pu, product(uwords.begin(), uwords.end()));
+      EXPECT_EQ(su, sum(uwords.begin(), uwords.end()));
+    }
+  }
+  big_integer::set_concurrency(concurrency);
+
+  std::vector<int> with_zero = {5, -3, 0, 7};
+  EXPECT_EQ(0, product(with_zero.begin(), with_zero.end()));
+  EXPECT_EQ(9, sum(with_zero.begin(), with_zero.end()));
+}
+
+TEST(correctness, factorial_binomial_primorial) {
+  big_integer f = 1;
+  std::vector<big_integer> factorials;
+  for (int n = 0; n != 300; ++n) {
+    if (n != 0)
+      f *= n;
+    factorials.push_back(f);
+    EXPECT_EQ(f, factorial(n));
+  }
+  for (int n = 0; n < 300; n += 7)
+    for (int k = 0; k <= n + 1; ++k)
+      EXPECT_EQ(k > n ? 0 : factorials[n] / (factorials[k] * factorials[n - k]), binomial(n, k));
+
+  big_integer p = 1;
+  for (int n = 0; n != 1000; ++n) {
+    bool prime = n >= 2;
+    for (int d = 2; d * d <= n; ++d)
+      prime &= n % d != 0;
+    if (prime)
+      p *= n;
+    EXPECT_EQ(p, primorial(n));
+  }
+
+  // larger than one sieve segment and one product leaf, checked against the naive loop
+  uint64_t const n = 100003;
+  big_integer naive = 1;
+  for (int i = 2; i <= static_cast<int>(n); ++i)
+    naive *= i;
+  EXPECT_EQ(naive, factorial(n));
+  EXPECT_EQ(naive / (factorial(40000) * factorial(n - 40000)), binomial(n, 40000));
+  EXPECT_EQ(binomial(n, 40000), binomial(n, n - 40000));
+  EXPECT_EQ(0, primorial(n) % 99991);
+  EXPECT_EQ(primorial(100000), primorial(n) / 100003);
+  // past the cached table size the primes are sieved per call, twice here
+  uint64_t const uncached = (uint64_t(1) << 24) + 3;
+  EXPECT_EQ(big_integer(std::to_string(uncached)), binomial(uncached, 1));
+  EXPECT_EQ(big_integer(std::to_string(uncached)), binomial(uncached, uncached - 1));
+  EXPECT_THROW(factorial(uint64_t(1) << 32), std::length_error);
+}
+
+TEST(correctness, sieve_small_segments) {
+  // with segments this short most base primes exceed them, as they do past n ~ 1e9
+  // with the real segment size
+  uint32_t const n = 200000;
+  std::vector<char> composite(n + 1);
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 2; i <= n; ++i) {
+    if (composite[i])
+      continue;
+    expected.push_back(i);
+    for (uint64_t j = uint64_t(i) * i; j <= n; j += i)
+      composite[j] = 1;
+  }
+  for (size_t segment : {1, 3, 16, 100, 32768}) {
+    EXPECT_EQ(expected, big_integer_detail::primes(n, segment));
+    EXPECT_EQ(std::vector<uint32_t>(expected.begin(), expected.begin() + 9592),
+              big_integer_detail::primes(99999, segment));
+  }
+}
+
+TEST(correctness, random_generation) {
+  std::mt19937_64 rng(17);
+  std::minstd_rand narrow(17);
+  EXPECT_EQ(0, big_integer::random_bits(0, rng));
+  uint64_t longest = 0;
+  for (size_t itn = 0; itn != 1000; ++itn) {
+    big_integer a = big_integer::random_bits(130, rng), b = big_integer::random_bits(130, narrow);
+    EXPECT_LE(0, a);
+    EXPECT_LE(0, b);
+    EXPECT_GT(big_integer(1) << 130, a);
+    EXPECT_GT(big_integer(1) << 130, b);
+    longest = std::max({longest, a.bit_length(), b.bit_length()});
+  }
+  EXPECT_EQ(130u, longest);
+
+  big_integer const bound = (big_integer(1) << 200) / 3;
+  std::vector<int> seen(10);
+  for (size_t itn = 0; itn != 1000; ++itn) {
+    big_integer a = big_integer::random_below(bound, rng);
+    EXPECT_LE(0, a);
+    EXPECT_GT(bound, a);
+    int digit = std::stoi(to_string(big_integer::random_below(10, narrow)));
+    ASSERT_TRUE(digit >= 0 && digit < 10);
+    seen[digit]++;
+  }
+  EXPECT_EQ(0, std::count(seen.begin(), seen.end(), 0));
+  EXPECT_THROW(big_integer::random_below(0, rng), std::invalid_argument);
+  EXPECT_THROW(big_integer::random_below(-5, rng), std::invalid_argument);
+
+  std::vector<big_integer> values(3, big_integer(-1));
+  big_integer::random_bits(values, 500, 64, rng);
+  EXPECT_EQ(500u, values.size());
+  for (big_integer const& v : values) {
+    EXPECT_LE(0, v);
+    EXPECT_GT(big_integer(1) << 64, v);
+  }
+  big_integer::random_bits(values, 20, 1000, rng);
+  EXPECT_EQ(20u, values.size());
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values.end(), std::adjacent_find(values.begin(), values.end()));
+}
+
+TEST(correctness, move) {
+  big_integer a("123456789012345678901234567890");
+  big_integer b = std::move(a);
+  EXPECT_EQ(big_integer("123456789012345678901234567890"), b);
+  a = 5;
+  EXPECT_EQ(5, a);
+  a = std::move(b);
+  EXPECT_EQ(big_integer("123456789012345678901234567890"), a);
+  b = a;
+  EXPECT_EQ(a, b);
+}
+
+TEST(correctness, stats) {
+  big_integer_stats::reset();
+  big_integer a(12345), b("1" + std::string(100, '0'));
+  big_integer c = a * b;
+  big_integer d = std::move(c);
+  std::thread([] { big_integer x(7); x *= x; }).join();
+  big_integer_stats::snapshot s = big_integer_stats::collect();
+  std::ostringstream out;
+  big_integer_stats::dump(out);
+
+  if (!big_integer_stats::enabled()) {
+    EXPECT_EQ(0u, s.events[big_integer_stats::constructions]);
+    EXPECT_EQ(0u, s.calls[big_integer_stats::mul][1]);
+    return;
+  }
+  EXPECT_LE(5u, s.events[big_integer_stats::constructions]);
+  EXPECT_LE(1u, s.events[big_integer_stats::moves]);
+  EXPECT_LT(0u, s.events[big_integer_stats::allocations]);
+  EXPECT_LT(0u, s.events[big_integer_stats::bytes_allocated]);
+  EXPECT_EQ(1u, s.calls[big_integer_stats::mul][3]); // 6 limbs
+  EXPECT_EQ(1u, s.calls[big_integer_stats::mul][1]); // from the finished thread
+  EXPECT_NE(std::string::npos, out.str().find("*: 2 calls"));
+
+  big_integer_stats::reset();
+  EXPECT_EQ(0u, big_integer_stats::collect().calls[big_integer_stats::mul][3]);
+  // nothing but zeros left to print
+  std::ostringstream empty;
+  big_integer_stats::dump(empty);
+  EXPECT_EQ("big_integer statistics\n", empty.str());
+}
+
+// every parallel path with thresholds low enough to split small operands
+TEST(correctness, small_thresholds) {
+  std::mt19937_64 rng(19);
+  std::vector<big_integer> values;
+  big_integer::random_bits(values, 37, 700, rng);
+  big_integer a = big_integer::random_bits(5000, rng), b = -big_integer::random_bits(3000, rng);
+  std::string str = to_string(a * b);
+  big_integer p = product(values.begin(), values.end()), s = sum(values.begin(), values.end());
+  std::vector<uint64_t> words(300, ~uint64_t(0));
+  big_integer w = product(words.begin(), words.end());
+
+  size_t concurrency = big_integer::concurrency();
+  big_integer_thresholds const defaults = active_big_integer_thresholds();
+  set_big_integer_thresholds({2, 2, 2, 0, 3});
+  EXPECT_EQ(2u, active_big_integer_thresholds().parallel_mul);
+  for (size_t threads : {1, 3, 8}) {
+    big_integer::set_concurrency(threads);
+    EXPECT_EQ(str, to_string(a * b));
+    EXPECT_EQ(a * b, big_integer(str));
+    // shorter than one parsing chunk, and just past one
+    EXPECT_EQ(12345, big_integer("12345"));
+    EXPECT_EQ(-7, big_integer("-7"));
+    EXPECT_EQ("1" + std::string(19, '0'), to_string(big_integer("1" + std::string(19, '0'))));
+    EXPECT_EQ(str, to_string(big_integer(str + "1") / 10));
+    EXPECT_EQ(p, product(values.begin(), values.end()));
+    EXPECT_EQ(s, sum(values.begin(), values.end()));
+    EXPECT_EQ(w, product(words.begin(), words.end()));
+  }
+  big_integer::set_concurrency(concurrency);
+  set_big_integer_thresholds(defaults);
+  EXPECT_EQ(default_big_integer_thresholds().parallel_mul, active_big_integer_thresholds().parallel_mul);
+}
+
+TEST(correctness, string_conv_parallel) {
+  std::default_random_engine rng(11);
+  size_t concurrency = big_integer::concurrency();
+  std::vector<std::string> numbers;
+  for (size_t bits : {400000, 1000000}) {
+    big_integer_gmp a;
+    a.random(bits, rng);
+    numbers.push_back(to_string(a));
+  }
+  numbers.push_back("1" + std::string(300000, '0'));
+  numbers.push_back("-1" + std::string(200000, '0') + "1");
+  numbers.push_back(std::string(150000, '9'));
+  numbers.push_back("0000" + std::string(150000, '7'));
+
+  for (std::string const& s : numbers) {
+    big_integer::set_concurrency(1);
+    big_integer serial(s);
+    std::string serial_str = to_string(serial);
+    for (size_t threads : {2, 5}) {
+      big_integer::set_concurrency(threads);
+      big_integer parallel(s);
+      EXPECT_EQ(serial, parallel);
+      EXPECT_EQ(serial_str, to_string(parallel));
+    }
+  }
+  big_integer::set_concurrency(4);
+  EXPECT_THROW(big_integer(std::string(150000, '1') + "x"), std::runtime_error);
+  big_integer::set_concurrency(concurrency);
+}
+
 // y2019 tests
 
 TEST(correctness_random, cmp) {
@@ -809,6 +1095,147 @@ TEST(correctness_random, bit_shifts) {
   }
 }
 
+TEST(correctness_random, bit_shifts_exhaustive) {
+  std::default_random_engine rng(3);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(max_size, rng);
+    big_integer R = big_integer(to_string(a));
+    int const m = static_cast<int>(max_size);
+    for (int shift : {0, 1, 31, 63, 64, 65, 127, 128, 640, 1000, m - 1, m, m + 1, 3 * m}) {
+      EXPECT_EQ(to_string(a << shift), to_string(R << shift)) << shift;
+      EXPECT_EQ(to_string(a >> shift), to_string(R >> shift)) << shift;
+    }
+  }
+}
+
+TEST(correctness, shift_64bit_count) {
+  uint64_t const huge = uint64_t(1) << 40;
+  EXPECT_EQ(0, big_integer(12345) >> huge);
+  EXPECT_EQ(-1, big_integer(-12345) >> huge);
+  EXPECT_EQ(0, big_integer(0) << huge);
+  EXPECT_EQ(-1, (big_integer(-1) << 100) >> 100);
+  EXPECT_EQ(big_integer("-18446744073709551616"), big_integer("-36893488147419103231") >> 1); // -(2^65 - 1) >> 1 == -2^64
+  EXPECT_EQ(big_integer("-18446744073709551616"), big_integer("-340282366920938463463374607431768211455") >> 64); // -(2^128 - 1) >> 64
+  EXPECT_THROW(big_integer(1) << std::numeric_limits<uint64_t>::max(), std::length_error);
+}
+
+TEST(correctness, bit_queries) {
+  big_integer a = (big_integer(1) << 200) + (big_integer(5) << 64);
+  EXPECT_EQ(201u, a.bit_length());
+  EXPECT_EQ(3u, a.popcount());
+  EXPECT_EQ(64u, a.count_trailing_zeros());
+  EXPECT_EQ(64u, a.scan1(0));
+  EXPECT_EQ(66u, a.scan1(65));
+  EXPECT_EQ(0u, a.scan0(0));
+  EXPECT_EQ(65u, a.scan0(64));
+  EXPECT_EQ(big_integer::npos, a.scan1(201));
+  EXPECT_TRUE(a.test_bit(200));
+  EXPECT_FALSE(a.test_bit(199));
+  EXPECT_FALSE(a.test_bit(100000));
+
+  big_integer zero;
+  EXPECT_EQ(0u, zero.bit_length());
+  EXPECT_EQ(0u, zero.popcount());
+  EXPECT_EQ(0u, zero.count_trailing_zeros());
+  EXPECT_EQ(big_integer::npos, zero.scan1(0));
+
+  big_integer m = -a; // two's complement: ones from bit 201 up, then ~a down to bit 65, 1, 64 zeros
+  EXPECT_EQ(201u, m.bit_length());
+  EXPECT_EQ(3u, m.popcount());
+  EXPECT_EQ(64u, m.count_trailing_zeros());
+  EXPECT_TRUE(m.test_bit(64));
+  EXPECT_TRUE(m.test_bit(65));
+  EXPECT_FALSE(m.test_bit(66));
+  EXPECT_FALSE(m.test_bit(200));
+  EXPECT_TRUE(m.test_bit(100000));
+  EXPECT_EQ(big_integer::npos, m.scan0(201));
+}
+
+TEST(correctness, bit_updates) {
+  std::default_random_engine rng(9);
+  for (size_t itn = 0; itn != 100; ++itn) {
+    big_integer_gmp g;
+    g.random(300, rng);
+    big_integer a(to_string(g));
+    for (uint64_t i : {0, 1, 63, 64, 150, 299, 300, 301, 500}) {
+      big_integer bit = big_integer(1) << i;
+      big_integer set = a, clear = a, flip = a;
+      set.set_bit(i);
+      clear.clear_bit(i);
+      flip.flip_bit(i);
+      EXPECT_EQ(a | bit, set);
+      EXPECT_EQ(a & ~bit, clear);
+      EXPECT_EQ(a ^ bit, flip);
+      EXPECT_EQ((a & bit) != 0, a.test_bit(i));
+      EXPECT_TRUE(set.test_bit(i));
+      EXPECT_FALSE(clear.test_bit(i));
+    }
+  }
+}
+
+TEST(correctness, hash) {
+  std::hash<big_integer> h;
+  big_integer a("123456789012345678901234567890");
+  big_integer zero;
+  EXPECT_EQ(h(zero), h(big_integer("0")));
+  EXPECT_EQ(h(zero), h(big_integer("-0")));
+  EXPECT_EQ(h(zero), h(-zero));
+  EXPECT_EQ(h(zero), h(a - a));
+  EXPECT_EQ(h(zero), h((a << 1000) >> 2000));
+  EXPECT_EQ(h(a), h(big_integer("123456789012345678901234567890")));
+  EXPECT_EQ(h(a), h(-(-a)));
+  EXPECT_EQ(h(a), h((a << 640) >> 640));
+  EXPECT_NE(h(a), h(-a));
+  EXPECT_NE(h(big_integer(1)), h(big_integer(1) << 64));
+
+  std::unordered_set<big_integer> set;
+  for (int i = -1000; i != 1000; ++i)
+    set.insert(big_integer(i) << 100);
+  EXPECT_EQ(2000u, set.size());
+  for (int i = -1000; i != 1000; ++i)
+    EXPECT_EQ(1u, set.count(big_integer(to_string(big_integer(i) << 100))));
+  EXPECT_EQ(0u, set.count(big_integer(1)));
+}
+
+// a hash taken before a mutation must not survive it
+TEST(correctness, hash_after_mutation) {
+  std::hash<big_integer> h;
+  big_integer const b("98765432109876543210");
+  auto check = [&](big_integer& a) {
+    EXPECT_EQ(h(big_integer(to_string(a))), h(a));
+  };
+  big_integer a("123456789012345678901234567890");
+  h(a);
+  a += b; check(a);
+  a -= 1; check(a);
+  a *= b; check(a);
+  a /= 7; check(a);
+  a %= b; check(a);
+  a &= b; check(a);
+  a |= 12345; check(a);
+  a ^= b; check(a);
+  a <<= 100; check(a);
+  a >>= 37; check(a);
+  ++a; check(a);
+  a++; check(a);
+  --a; check(a);
+  a--; check(a);
+  a.set_bit(3); check(a);
+  a.clear_bit(64); check(a);
+  a.flip_bit(200); check(a);
+  a = b; check(a);
+  big_integer c = a;
+  c += 1;
+  check(a);
+  check(c);
+  std::vector<big_integer> v(1, a);
+  h(v[0]);
+  std::mt19937_64 rng(5);
+  big_integer::random_bits(v, 1, 300, rng);
+  check(v[0]);
+}
+
 // TODO: extend due to idea
 TEST(correctness_twos_complement, simple) {
   std::string a = "-36893488147419103232"; // -(1 << 65)
@@ -835,3 +1262,200 @@ TEST(correctness_twos_complement, all_ones) {
 
   EXPECT_EQ(to_string(gmp_ans), to_string(your_ans));
 }
+
+TEST(correctness_twos_complement, boundaries) {
+  std::vector<std::string> values = {"0", "1", "-1"};
+  for (int k : {63, 64, 65, 127, 128, 192}) {
+    big_integer_gmp p = big_integer_gmp(1) << k;
+    for (big_integer_gmp v : {p, p - 1, p + 1}) {
+      values.push_back(to_string(v));
+      values.push_back(to_string(-v));
+    }
+  }
+
+  for (std::string const& a : values) {
+    for (std::string const& b : values) {
+      big_integer_gmp gmp_a(a), gmp_b(b);
+      big_integer your_a(a), your_b(b);
+      EXPECT_EQ(to_string(gmp_a & gmp_b), to_string(your_a & your_b)) << a << " & " << b;
+      EXPECT_EQ(to_string(gmp_a | gmp_b), to_string(your_a | your_b)) << a << " | " << b;
+      EXPECT_EQ(to_string(gmp_a ^ gmp_b), to_string(your_a ^ your_b)) << a << " ^ " << b;
+    }
+    big_integer self(a);
+    self &= self;
+    EXPECT_EQ(a, to_string(self));
+    self |= self;
+    EXPECT_EQ(a, to_string(self));
+    self ^= self;
+    EXPECT_EQ(0, self);
+  }
+}
+
+TEST(fixed_integer, constexpr_arithmetic) {
+  using u128 = fixed_integer<128, false>;
+  constexpr u128 a = u128(1) << 100;
+  constexpr u128 b = a * 3 + 7;
+  static_assert((b - 7) / 3 == a, "constexpr division");
+  static_assert(b % 3 == 1, "constexpr remainder");
+  static_assert(~u128(0) + 1 == 0, "wrap around");
+  EXPECT_EQ("3802951800684688204490109616135", to_string(b));
+}
+
+TEST(fixed_integer, signed_semantics) {
+  using i256 = fixed_integer<256>;
+  EXPECT_EQ(i256(-7), i256(7) - 14);
+  EXPECT_TRUE(i256(-1) < i256(0));
+  EXPECT_EQ(-3, i256(-7) / 2);
+  EXPECT_EQ(-1, i256(-7) % 2);
+  EXPECT_EQ(-4, i256(-7) >> 1);
+  EXPECT_EQ(-1, i256(-1) >> 200);
+  EXPECT_EQ(8, i256(-7) & 14);
+  EXPECT_EQ("-1", to_string(i256(-1)));
+  EXPECT_EQ("0", to_string(i256()));
+}
+
+TEST(fixed_integer, string_conv) {
+  std::string s = "-57896044618658097711785492504343953926634992332820282019728792003956564819968";
+  fixed_integer<256> a(s);
+  EXPECT_EQ(s, to_string(a));
+  EXPECT_EQ(a, a - 1 + 1);
+  EXPECT_THROW(fixed_integer<256>("12a"), std::runtime_error);
+  EXPECT_THROW(fixed_integer<256>(""), std::runtime_error);
+}
+
+TEST(fixed_integer, big_integer_conversion) {
+  big_integer a("-340282366920938463463374607431768211457"); // -(2^128 + 1)
+  EXPECT_EQ(a, big_integer(fixed_integer<256>(a)));
+  EXPECT_EQ(big_integer(-1), big_integer(fixed_integer<128>(a)));
+  EXPECT_EQ(big_integer(1), big_integer(fixed_integer<128>(-a)));
+  EXPECT_EQ(big_integer(0), big_integer(fixed_integer<512>()));
+}
+
+namespace {
+template<size_t Bits>
+void check_fixed_random(std::default_random_engine& rng) {
+  using fixed = fixed_integer<Bits>;
+  for (size_t itn = 0; itn != 100; ++itn) {
+    big_integer_gmp a, b;
+    a.random(Bits / 2 - 2, rng);
+    b.random(Bits / 2 - 2 - itn % (Bits / 4), rng);
+    if (b == 0)
+      continue;
+    big_integer A(to_string(a)), B(to_string(b));
+    fixed x(A), y(B);
+
+    EXPECT_EQ(to_string(a + b), to_string(x + y));
+    EXPECT_EQ(to_string(a - b), to_string(x - y));
+    EXPECT_EQ(to_string(a * b), to_string(x * y));
+    EXPECT_EQ(to_string(a / b), to_string(x / y));
+    EXPECT_EQ(to_string(a % b), to_string(x % y));
+    EXPECT_EQ(to_string(a & b), to_string(x & y));
+    EXPECT_EQ(to_string(a | b), to_string(x | y));
+    EXPECT_EQ(to_string(a ^ b), to_string(x ^ y));
+    EXPECT_EQ(to_string(a << 5), to_string(x << 5));
+    EXPECT_EQ(to_string(a >> 70), to_string(x >> 70));
+    EXPECT_EQ(a < b, x < y);
+    EXPECT_EQ(A * B, big_integer(x * y));
+  }
+}
+}
+
+TEST(fixed_integer, randomized) {
+  std::default_random_engine rng(42);
+  check_fixed_random<128>(rng);
+  check_fixed_random<256>(rng);
+  check_fixed_random<512>(rng);
+  check_fixed_random<1024>(rng);
+}
+
+TEST(fixed_integer, literals) {
+  constexpr auto m127 = 170141183460469231731687303715884105727_bi;
+  static_assert(sizeof(m127) == 3 * sizeof(uint64_t), "literal width");
+  static_assert(m127 == (decltype(m127)(1) << 127) - 1, "literal value");
+  EXPECT_EQ((big_integer(1) << 127) - 1, big_integer(m127));
+
+  constexpr auto hex = 0xFFFF'FFFF'FFFF'FFFF'FFFF_bi;
+  EXPECT_EQ((big_integer(1) << 80) - 1, big_integer(hex));
+  EXPECT_EQ(big_integer(-8), big_integer(-0b1000_bi));
+  EXPECT_EQ(big_integer(511), big_integer(0777_bi));
+  EXPECT_EQ(big_integer(0), big_integer(0_bi));
+}
+
+TEST(limb_kernels, variants_agree) {
+  std::mt19937_64 rng(5);
+  limb_kernels const original = active_limb_kernels();
+  ASSERT_TRUE(force_limb_kernels("portable"));
+  limb_kernels const portable = active_limb_kernels();
+
+  for (std::string const& name : supported_limb_kernels()) {
+    ASSERT_TRUE(force_limb_kernels(name));
+    limb_kernels const k = active_limb_kernels();
+    for (size_t n : {1, 2, 3, 4, 5, 7, 8, 9, 16, 17, 31, 1000}) {
+      std::vector<mp_limb_t> a(n), b(n), r1(n), r2(n);
+      for (size_t i = 0; i != n; ++i) {
+        a[i] = rng();
+        b[i] = i % 3 == 0 ? ~mp_limb_t(0) : rng();
+      }
+      mp_limb_t m = rng();
+
+      EXPECT_EQ(portable.add_n(r1.data(), a.data(), b.data(), n), k.add_n(r2.data(), a.data(), b.data(), n)) << name;
+      EXPECT_EQ(r1, r2) << name;
+      EXPECT_EQ(portable.sub_n(r1.data(), a.data(), b.data(), n), k.sub_n(r2.data(), a.data(), b.data(), n)) << name;
+      EXPECT_EQ(r1, r2) << name;
+      EXPECT_EQ(portable.mul_1(r1.data(), a.data(), n, m), k.mul_1(r2.data(), a.data(), n, m)) << name;
+      EXPECT_EQ(r1, r2) << name;
+      EXPECT_EQ(portable.mul_1(r1.data(), a.data(), n, ~mp_limb_t(0)), k.mul_1(r2.data(), a.data(), n, ~mp_limb_t(0))) << name;
+      EXPECT_EQ(r1, r2) << name;
+      r1 = b;
+      r2 = b;
+      EXPECT_EQ(portable.addmul_1(r1.data(), a.data(), n, m), k.addmul_1(r2.data(), a.data(), n, m)) << name;
+      EXPECT_EQ(r1, r2) << name;
+      EXPECT_EQ(portable.addmul_1(r1.data(), a.data(), n, ~mp_limb_t(0)), k.addmul_1(r2.data(), a.data(), n, ~mp_limb_t(0))) << name;
+      EXPECT_EQ(r1, r2) << name;
+
+      portable.and_n(r1.data(), a.data(), b.data(), n);
+      k.and_n(r2.data(), a.data(), b.data(), n);
+      EXPECT_EQ(r1, r2) << name;
+      portable.ior_n(r1.data(), a.data(), b.data(), n);
+      k.ior_n(r2.data(), a.data(), b.data(), n);
+      EXPECT_EQ(r1, r2) << name;
+      portable.xor_n(r1.data(), a.data(), b.data(), n);
+      k.xor_n(r2.data(), a.data(), b.data(), n);
+      EXPECT_EQ(r1, r2) << name;
+
+      for (unsigned shift : {1u, 13u, 63u}) {
+        std::vector<mp_limb_t> in_place(a);
+        EXPECT_EQ(portable.lshift(r1.data(), a.data(), n, shift), k.lshift(in_place.data(), in_place.data(), n, shift)) << name;
+        EXPECT_EQ(r1, in_place) << name;
+        in_place = a;
+        EXPECT_EQ(portable.rshift(r1.data(), a.data(), n, shift), k.rshift(in_place.data(), in_place.data(), n, shift)) << name;
+        EXPECT_EQ(r1, in_place) << name;
+      }
+    }
+
+    // product() builds its word leaves with mul_1 and addmul_1, odd counts end on a single word
+    std::vector<uint64_t> words(300);
+    big_integer expected = 1;
+    for (uint64_t& w : words) {
+      w = rng() | 1;
+      expected *= big_integer(std::to_string(w));
+    }
+    EXPECT_EQ(expected, product(words.begin(), words.end())) << name;
+    EXPECT_EQ(expected / big_integer(std::to_string(words.back())), product(words.begin(), words.end() - 1)) << name;
+
+    std::default_random_engine gen(42);
+    for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+      big_integer_gmp a, b;
+      a.random(max_size, gen);
+      b.random(max_size / 3, gen);
+      big_integer A(to_string(a)), B(to_string(b));
+      EXPECT_EQ(to_string(a & b), to_string(A & B)) << name;
+      EXPECT_EQ(to_string(b | a), to_string(B | A)) << name;
+      EXPECT_EQ(to_string(a ^ b), to_string(A ^ B)) << name;
+      EXPECT_EQ(to_string(a ^ a), to_string(A ^ A)) << name;
+    }
+  }
+
+  force_limb_kernels(original.arithmetic);
+  force_limb_kernels(original.bitwise);
+}
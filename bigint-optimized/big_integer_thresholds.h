@@ -0,0 +1,31 @@
+#ifndef BIG_INTEGER_THRESHOLDS_H
+#define BIG_INTEGER_THRESHOLDS_H
+
+#include <cstddef>
+
+// Operand sizes at which big_integer switches algorithms. The values start out
+// as the BIGINT_*_THRESHOLD macros of bigint_thresholds.h, either the defaults
+// in thresholds/ or the header big_integer_tune generated for this machine.
+struct big_integer_thresholds
+{
+    // smaller factor, in limbs, from which a multiplication is split over threads
+    size_t parallel_mul;
+    // limbs from which decimal conversion is split over threads
+    size_t parallel_to_string;
+    // decimal digits from which parsing is split over threads
+    size_t parallel_parse;
+    // total limbs of a product() or sum() tree level whose pairs run in parallel
+    size_t parallel_tree;
+    // limbs gathered with mpz_mul_ui before a word product() starts its tree
+    size_t product_leaf_limbs;
+};
+
+big_integer_thresholds const& active_big_integer_thresholds();
+
+// the values compiled in from bigint_thresholds.h
+big_integer_thresholds default_big_integer_thresholds();
+
+// for the tuner and tests; not thread-safe with respect to running operations
+void set_big_integer_thresholds(big_integer_thresholds const& thresholds);
+
+#endif // BIG_INTEGER_THRESHOLDS_H
@@ -0,0 +1,14 @@
+#ifndef BIGINT_THRESHOLDS_H
+#define BIGINT_THRESHOLDS_H
+
+// Default crossovers of big_integer_thresholds, used until the host has been
+// measured: `make tune` runs big_integer_tune, which writes a replacement into
+// the build directory that later builds include instead of this file.
+
+#define BIGINT_PARALLEL_MUL_THRESHOLD 4000
+#define BIGINT_PARALLEL_TO_STRING_THRESHOLD 5000
+#define BIGINT_PARALLEL_PARSE_THRESHOLD 100000
+#define BIGINT_PARALLEL_TREE_THRESHOLD 2000
+#define BIGINT_PRODUCT_LEAF_LIMBS 16
+
+#endif // BIGINT_THRESHOLDS_H
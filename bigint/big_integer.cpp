@@ -1,25 +1,435 @@
 #include "big_integer.h"
+#include "big_integer_stats.h"
+#include "big_integer_thresholds.h"
+#include "bigint_thresholds.h"
+#include "limb_kernels.h"
+#include "thread_pool.h"
 
+#include <algorithm>
 #include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+
+namespace
+{
+big_integer_thresholds thresholds = {
+    BIGINT_PARALLEL_MUL_THRESHOLD,
+    BIGINT_PARALLEL_TO_STRING_THRESHOLD,
+    BIGINT_PARALLEL_PARSE_THRESHOLD,
+    BIGINT_PARALLEL_TREE_THRESHOLD,
+    BIGINT_PRODUCT_LEAF_LIMBS,
+};
+
+using big_integer_stats_detail::count;
+
+size_t operand_limbs(mpz_srcptr a, mpz_srcptr b)
+{
+    return std::max(mpz_size(a), mpz_size(b));
+}
+
+// owning mpz_t for temporaries kept in containers
+struct mpz_value
+{
+    mpz_value()
+    {
+        mpz_init(value);
+    }
+
+    mpz_value(mpz_value const&) = delete;
+    mpz_value& operator=(mpz_value const&) = delete;
+
+    ~mpz_value()
+    {
+        mpz_clear(value);
+    }
+
+    mpz_t value;
+};
+
+// read-only non-negative view of limbs [offset, offset + length) of |x|
+mpz_srcptr limb_view(mpz_t view, mpz_srcptr x, size_t offset, size_t length)
+{
+    size_t size = mpz_size(x);
+    offset = std::min(offset, size);
+    length = std::min(length, size - offset);
+    return mpz_roinit_n(view, mpz_limbs_read(x) + offset, static_cast<mp_size_t>(length));
+}
+
+void mul_parallel(mpz_ptr r, mpz_srcptr a, mpz_srcptr b, size_t threads);
+
+// |a| >= 2 |b|: a is cut into pieces that are multiplied by b independently
+void mul_unbalanced(mpz_ptr r, mpz_srcptr a, mpz_srcptr b, size_t threads)
+{
+    size_t n = mpz_size(a);
+    size_t m = mpz_size(b);
+    size_t pieces = std::min(threads, n / m);
+    size_t length = (n + pieces - 1) / pieces;
+    pieces = (n + length - 1) / length;
+
+    std::unique_ptr<mpz_t[]> products(new mpz_t[pieces]);
+    for (size_t i = 0; i != pieces; i++)
+    {
+        mpz_init(products[i]);
+    }
+    thread_pool::instance().parallel_for(pieces, [&](size_t i) {
+        mpz_t view;
+        mul_parallel(products[i], limb_view(view, a, i * length, length), b, threads / pieces);
+    });
+
+    size_t total = n + m;
+    mp_limb_t* rp = mpz_limbs_write(r, static_cast<mp_size_t>(total));
+    std::fill(rp, rp + total, 0);
+    for (size_t i = 0; i != pieces; i++)
+    {
+        size_t offset = i * length;
+        size_t size = mpz_size(products[i]);
+        mp_limb_t carry = active_limb_kernels().add_n(rp + offset, rp + offset, mpz_limbs_read(products[i]), size);
+        for (size_t j = offset + size; carry != 0 && j != total; j++)
+        {
+            carry = ++rp[j] == 0;
+        }
+        mpz_clear(products[i]);
+    }
+    while (total != 0 && rp[total - 1] == 0)
+    {
+        total--;
+    }
+    mpz_limbs_finish(r, static_cast<mp_size_t>(total));
+}
+
+// r = a * b for non-negative a and b, r must not alias them. Balanced operands take one
+// Karatsuba step whose three half-size products are computed in parallel.
+void mul_parallel(mpz_ptr r, mpz_srcptr a, mpz_srcptr b, size_t threads)
+{
+    if (mpz_size(a) < mpz_size(b))
+    {
+        std::swap(a, b);
+    }
+    size_t n = mpz_size(a);
+    size_t m = mpz_size(b);
+    if (threads < 2 || m < thresholds.parallel_mul)
+    {
+        mpz_mul(r, a, b);
+        return;
+    }
+    if (n >= 2 * m)
+    {
+        mul_unbalanced(r, a, b, threads);
+        return;
+    }
+
+    size_t half = n / 2;
+    mpz_t a0_view, a1_view, b0_view, b1_view;
+    mpz_srcptr a0 = limb_view(a0_view, a, 0, half);
+    mpz_srcptr a1 = limb_view(a1_view, a, half, n);
+    mpz_srcptr b0 = limb_view(b0_view, b, 0, half);
+    mpz_srcptr b1 = limb_view(b1_view, b, half, m);
+
+    mpz_t low, high, mid, a_sum, b_sum;
+    mpz_inits(low, high, mid, a_sum, b_sum, nullptr);
+    mpz_add(a_sum, a0, a1);
+    mpz_add(b_sum, b0, b1);
+    thread_pool::instance().parallel_for(3, [&](size_t i) {
+        size_t sub_threads = (threads + 2) / 3;
+        if (i == 0)
+        {
+            mul_parallel(low, a0, b0, sub_threads);
+        }
+        else if (i == 1)
+        {
+            mul_parallel(high, a1, b1, sub_threads);
+        }
+        else
+        {
+            mul_parallel(mid, a_sum, b_sum, sub_threads);
+        }
+    });
+
+    mpz_sub(mid, mid, low);
+    mpz_sub(mid, mid, high);
+    mpz_mul_2exp(r, high, 64 * half);
+    mpz_add(r, r, mid);
+    mpz_mul_2exp(r, r, 64 * half);
+    mpz_add(r, r, low);
+    mpz_clears(low, high, mid, a_sum, b_sum, nullptr);
+}
+
+// x = x op y for non-negative x and y; the limbs of the longer operand past the
+// shorter one are kept for | and ^ and dropped for &
+void bitwise_nonnegative(mpz_ptr x, mpz_srcptr y, void (*kernel)(mp_limb_t*, mp_limb_t const*, mp_limb_t const*, size_t), bool is_and)
+{
+    size_t x_size = mpz_size(x);
+    size_t y_size = mpz_size(y);
+    size_t common = std::min(x_size, y_size);
+    size_t n = is_and ? common : std::max(x_size, y_size);
+    if (n == 0)
+    {
+        mpz_set_ui(x, 0);
+        return;
+    }
+    mp_limb_t* rp = mpz_limbs_modify(x, static_cast<mp_size_t>(n));
+    mp_limb_t const* yp = mpz_limbs_read(y);
+    if (common != 0)
+    {
+        kernel(rp, rp, yp, common);
+    }
+    if (!is_and && y_size > x_size)
+    {
+        std::copy(yp + x_size, yp + y_size, rp + x_size);
+    }
+    while (n != 0 && rp[n - 1] == 0)
+    {
+        n--;
+    }
+    mpz_limbs_finish(x, static_cast<mp_size_t>(n));
+}
+
+// Produces the infinite two's complement limbs of x one at a time; for negative x the
+// magnitude is complemented and incremented on the fly instead of in a temporary
+struct twos_complement_reader
+{
+    explicit twos_complement_reader(mpz_srcptr x)
+        : limbs_(mpz_limbs_read(x)), size_(mpz_size(x)), negative_(mpz_sgn(x) < 0), carry_(1)
+    {}
+
+    // limb i, must be called for i = 0, 1, 2, ... in order
+    mp_limb_t next(size_t i)
+    {
+        mp_limb_t limb = i < size_ ? limbs_[i] : 0;
+        if (!negative_)
+        {
+            return limb;
+        }
+        mp_limb_t res = ~limb + carry_;
+        carry_ &= limb == 0;
+        return res;
+    }
+
+private:
+    mp_limb_t const* limbs_;
+    size_t size_;
+    bool negative_;
+    mp_limb_t carry_;
+};
+
+// x = x op y with infinite two's complement semantics in a single pass over the limbs.
+// The result has at most `length` significant limbs (plus a final carry when it is
+// negative, since then every limb above `length` is all ones in two's complement).
+template<typename Op>
+void bitwise_signed(mpz_ptr x, mpz_srcptr y, Op op, bool negative_result, size_t length)
+{
+    mp_limb_t* rp = mpz_limbs_modify(x, static_cast<mp_size_t>(length + 1));
+    twos_complement_reader a(x);
+    twos_complement_reader b(y);
+    mp_limb_t carry = 1;
+    for (size_t i = 0; i != length; i++)
+    {
+        mp_limb_t limb = op(a.next(i), b.next(i));
+        if (negative_result)
+        {
+            mp_limb_t magnitude = ~limb + carry;
+            carry &= limb == 0;
+            limb = magnitude;
+        }
+        rp[i] = limb;
+    }
+    size_t n = length;
+    if (negative_result)
+    {
+        rp[n++] = carry;
+    }
+    while (n != 0 && rp[n - 1] == 0)
+    {
+        n--;
+    }
+    mp_size_t size = static_cast<mp_size_t>(n);
+    mpz_limbs_finish(x, negative_result ? -size : size);
+}
+
+std::string get_str(mpz_srcptr x)
+{
+    char* tmp = mpz_get_str(NULL, 10, x);
+    std::string res = tmp;
+
+    void (*freefunc)(void*, size_t);
+    mp_get_memory_functions (NULL, NULL, &freefunc);
+
+    freefunc(tmp, strlen(tmp) + 1);
+
+    return res;
+}
+
+// decimal conversion splits numbers by powers[level] = 10^chunk_digits(level)
+size_t chunk_digits(size_t level)
+{
+    return size_t(19) << level;
+}
+
+void push_square(std::deque<mpz_value>& powers)
+{
+    if (powers.empty())
+    {
+        powers.emplace_back();
+        mpz_ui_pow_ui(powers.back().value, 10, chunk_digits(0));
+        return;
+    }
+    mpz_srcptr last = powers.back().value;
+    powers.emplace_back();
+    mpz_mul(powers.back().value, last, last);
+}
+
+// x < powers[level]^2 and x >= 0; padded output has exactly 2 * chunk_digits(level) digits
+std::string to_string_parallel(mpz_srcptr x, std::deque<mpz_value> const& powers, size_t level, bool padded, size_t threads)
+{
+    if (!padded && level != 0 && mpz_cmp(x, powers[level].value) < 0)
+    {
+        return to_string_parallel(x, powers, level - 1, false, threads);
+    }
+    if (threads < 2 || level == 0 || mpz_size(x) < thresholds.parallel_to_string)
+    {
+        std::string res = get_str(x);
+        size_t width = 2 * chunk_digits(level);
+        if (padded && res.size() < width)
+        {
+            res.insert(0, width - res.size(), '0');
+        }
+        return res;
+    }
+
+    mpz_value q, r;
+    mpz_tdiv_qr(q.value, r.value, x, powers[level].value);
+    std::string high, low;
+    thread_pool::instance().parallel_for(2, [&](size_t i) {
+        if (i == 0)
+        {
+            high = to_string_parallel(q.value, powers, level - 1, padded, threads / 2);
+        }
+        else
+        {
+            low = to_string_parallel(r.value, powers, level - 1, true, threads - threads / 2);
+        }
+    });
+    return high + low;
+}
+
+bool is_decimal(std::string const& str)
+{
+    size_t i = !str.empty() && str[0] == '-' ? 1 : 0;
+    if (i == str.size())
+    {
+        return false;
+    }
+    for (; i != str.size(); i++)
+    {
+        if (str[i] < '0' || str[i] > '9')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// r = value of the decimal digits [digits, digits + length); the lowest chunk_digits(level)
+// digits and the rest are parsed in parallel and joined as high * powers[level] + low.
+// Up to chunk_digits(0) digits there is nothing to split off, whatever the threshold.
+void parse_parallel(mpz_ptr r, char const* digits, size_t length, std::deque<mpz_value> const& powers, size_t threads)
+{
+    if (threads < 2 || length < thresholds.parallel_parse || length <= chunk_digits(0))
+    {
+        mpz_set_str(r, std::string(digits, length).c_str(), 10);
+        return;
+    }
+    size_t level = 0;
+    while (chunk_digits(level + 1) < length)
+    {
+        level++;
+    }
+    size_t low_length = chunk_digits(level);
+
+    mpz_value high, low;
+    thread_pool::instance().parallel_for(2, [&](size_t i) {
+        if (i == 0)
+        {
+            parse_parallel(high.value, digits, length - low_length, powers, threads / 2);
+        }
+        else
+        {
+            parse_parallel(low.value, digits + length - low_length, low_length, powers, threads - threads / 2);
+        }
+    });
+    mul_parallel(r, high.value, powers[level].value, threads);
+    mpz_add(r, r, low.value);
+}
+
+uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// one multiply per limb; mpz keeps no negative zero and no leading zero limbs, so
+// equal values always present the same (size, limbs) pair
+size_t hash_limbs(mpz_srcptr x)
+{
+    mp_limb_t const* limbs = mpz_limbs_read(x);
+    size_t size = mpz_size(x);
+    uint64_t h = size * 0x9e3779b97f4a7c15ull + (mpz_sgn(x) < 0);
+    for (size_t i = 0; i != size; i++)
+    {
+        h = ((h << 5 | h >> 59) ^ limbs[i]) * 0x9ddfea08eb382d69ull;
+    }
+    return static_cast<size_t>(mix(h));
+}
+}
 
 big_integer::big_integer()
 {
+    count(big_integer_stats::constructions);
     mpz_init(mpz);
 }
 
 big_integer::big_integer(big_integer const& other)
 {
+    count(big_integer_stats::constructions);
+    count(big_integer_stats::copies);
     mpz_init_set(mpz, other.mpz);
 }
 
 big_integer::big_integer(int a)
 {
+    count(big_integer_stats::constructions);
     mpz_init_set_si(mpz, a);
 }
 
 big_integer::big_integer(std::string const& str)
 {
+    count(big_integer_stats::constructions);
+    count(big_integer_stats::parse, str.size() / 19);
+    size_t threads = concurrency();
+    if (threads >= 2 && str.size() >= thresholds.parallel_parse && is_decimal(str))
+    {
+        bool negative = str[0] == '-';
+        size_t length = str.size() - negative;
+        std::deque<mpz_value> powers;
+        while (powers.empty() || chunk_digits(powers.size()) < length)
+        {
+            push_square(powers);
+        }
+        mpz_init(mpz);
+        parse_parallel(mpz, str.data() + negative, length, powers, threads);
+        if (negative)
+        {
+            mpz_neg(mpz, mpz);
+        }
+        return;
+    }
     if (mpz_init_set_str(mpz, str.c_str(), 10))
     {
         mpz_clear(mpz);
@@ -27,6 +437,14 @@ big_integer::big_integer(std::string const& str)
     }
 }
 
+big_integer::big_integer(big_integer&& other) noexcept
+{
+    count(big_integer_stats::constructions);
+    count(big_integer_stats::moves);
+    mpz_init(mpz);
+    mpz_swap(mpz, other.mpz);
+}
+
 big_integer::~big_integer()
 {
     mpz_clear(mpz);
@@ -34,67 +452,198 @@ big_integer::~big_integer()
 
 big_integer& big_integer::operator=(big_integer const& other)
 {
+    count(big_integer_stats::copies);
     mpz_set(mpz, other.mpz);
     return *this;
 }
 
+big_integer& big_integer::operator=(big_integer&& other) noexcept
+{
+    count(big_integer_stats::moves);
+    swap(other);
+    return *this;
+}
+
+void big_integer::swap(big_integer& other)
+{
+    mpz_swap(mpz, other.mpz);
+}
+
 big_integer& big_integer::operator+=(big_integer const& rhs)
 {
+    count(big_integer_stats::add, operand_limbs(mpz, rhs.mpz));
     mpz_add(mpz, mpz, rhs.mpz);
     return *this;
 }
 
 big_integer& big_integer::operator-=(big_integer const& rhs)
 {
+    count(big_integer_stats::sub, operand_limbs(mpz, rhs.mpz));
     mpz_sub(mpz, mpz, rhs.mpz);
     return *this;
 }
 
 big_integer& big_integer::operator*=(big_integer const& rhs)
 {
-    mpz_mul(mpz, mpz, rhs.mpz);
+    count(big_integer_stats::mul, operand_limbs(mpz, rhs.mpz));
+    size_t threads = concurrency();
+    if (threads < 2 || std::min(mpz_size(mpz), mpz_size(rhs.mpz)) < thresholds.parallel_mul)
+    {
+        mpz_mul(mpz, mpz, rhs.mpz);
+        return *this;
+    }
+    bool negative = (mpz_sgn(mpz) < 0) != (mpz_sgn(rhs.mpz) < 0);
+    mpz_t a_view, b_view, r;
+    mpz_init(r);
+    mul_parallel(r, limb_view(a_view, mpz, 0, mpz_size(mpz)), limb_view(b_view, rhs.mpz, 0, mpz_size(rhs.mpz)), threads);
+    if (negative)
+    {
+        mpz_neg(r, r);
+    }
+    mpz_swap(mpz, r);
+    mpz_clear(r);
     return *this;
 }
 
 big_integer& big_integer::operator/=(big_integer const& rhs)
 {
+    count(big_integer_stats::div, operand_limbs(mpz, rhs.mpz));
     mpz_tdiv_q(mpz, mpz, rhs.mpz);
     return *this;
 }
 
 big_integer& big_integer::operator%=(big_integer const& rhs)
 {
+    count(big_integer_stats::mod, operand_limbs(mpz, rhs.mpz));
     mpz_tdiv_r(mpz, mpz, rhs.mpz);
     return *this;
 }
 
 big_integer& big_integer::operator&=(big_integer const& rhs)
 {
-    mpz_and(mpz, mpz, rhs.mpz);
+    count(big_integer_stats::bit_and, operand_limbs(mpz, rhs.mpz));
+    bool negative = mpz_sgn(mpz) < 0;
+    bool rhs_negative = mpz_sgn(rhs.mpz) < 0;
+    if (!negative && !rhs_negative)
+    {
+        bitwise_nonnegative(mpz, rhs.mpz, active_limb_kernels().and_n, true);
+        return *this;
+    }
+    // a non-negative operand bounds the result, otherwise it is negative and may be as long as either
+    size_t length = !negative ? mpz_size(mpz) : !rhs_negative ? mpz_size(rhs.mpz) : std::max(mpz_size(mpz), mpz_size(rhs.mpz));
+    bitwise_signed(mpz, rhs.mpz, [](mp_limb_t a, mp_limb_t b) { return a & b; }, negative && rhs_negative, length);
     return *this;
 }
 
 big_integer& big_integer::operator|=(big_integer const& rhs)
 {
-    mpz_ior(mpz, mpz, rhs.mpz);
+    count(big_integer_stats::bit_or, operand_limbs(mpz, rhs.mpz));
+    bool negative = mpz_sgn(mpz) < 0;
+    bool rhs_negative = mpz_sgn(rhs.mpz) < 0;
+    if (!negative && !rhs_negative)
+    {
+        bitwise_nonnegative(mpz, rhs.mpz, active_limb_kernels().ior_n, false);
+        return *this;
+    }
+    // the result is negative and no longer than any negative operand
+    size_t length = !negative ? mpz_size(rhs.mpz) : !rhs_negative ? mpz_size(mpz) : std::min(mpz_size(mpz), mpz_size(rhs.mpz));
+    bitwise_signed(mpz, rhs.mpz, [](mp_limb_t a, mp_limb_t b) { return a | b; }, true, length);
     return *this;
 }
 
 big_integer& big_integer::operator^=(big_integer const& rhs)
 {
-    mpz_xor(mpz, mpz, rhs.mpz);
+    count(big_integer_stats::bit_xor, operand_limbs(mpz, rhs.mpz));
+    bool negative = mpz_sgn(mpz) < 0;
+    bool rhs_negative = mpz_sgn(rhs.mpz) < 0;
+    if (!negative && !rhs_negative)
+    {
+        bitwise_nonnegative(mpz, rhs.mpz, active_limb_kernels().xor_n, false);
+        return *this;
+    }
+    size_t length = std::max(mpz_size(mpz), mpz_size(rhs.mpz));
+    bitwise_signed(mpz, rhs.mpz, [](mp_limb_t a, mp_limb_t b) { return a ^ b; }, negative != rhs_negative, length);
     return *this;
 }
 
-big_integer& big_integer::operator<<=(int rhs)
+big_integer& big_integer::operator<<=(uint64_t rhs)
 {
-    mpz_mul_2exp(mpz, mpz, rhs);
+    count(big_integer_stats::shl, mpz_size(mpz));
+    size_t size = mpz_size(mpz);
+    if (size == 0)
+    {
+        return *this;
+    }
+    uint64_t words = rhs / GMP_NUMB_BITS;
+    unsigned bits = static_cast<unsigned>(rhs % GMP_NUMB_BITS);
+    // mpz stores its limb count in an int
+    if (words > static_cast<uint64_t>(std::numeric_limits<int>::max()) - size - 1)
+    {
+        throw std::length_error("big_integer is too large");
+    }
+    size_t n = size + static_cast<size_t>(words);
+    bool negative = mpz_sgn(mpz) < 0;
+    mp_limb_t* rp = mpz_limbs_modify(mpz, static_cast<mp_size_t>(n + 1));
+    if (bits == 0)
+    {
+        std::memmove(rp + words, rp, size * sizeof(mp_limb_t));
+    }
+    else
+    {
+        rp[n++] = active_limb_kernels().lshift(rp + words, rp, size, bits);
+    }
+    std::fill(rp, rp + words, 0);
+    while (rp[n - 1] == 0)
+    {
+        n--;
+    }
+    mpz_limbs_finish(mpz, negative ? -static_cast<mp_size_t>(n) : static_cast<mp_size_t>(n));
     return *this;
 }
 
-big_integer& big_integer::operator>>=(int rhs)
+// rounds towards negative infinity, like an arithmetic shift of the two's complement form
+big_integer& big_integer::operator>>=(uint64_t rhs)
 {
-    mpz_div_2exp(mpz, mpz, rhs);
+    count(big_integer_stats::shr, mpz_size(mpz));
+    size_t size = mpz_size(mpz);
+    bool negative = mpz_sgn(mpz) < 0;
+    uint64_t words = rhs / GMP_NUMB_BITS;
+    unsigned bits = static_cast<unsigned>(rhs % GMP_NUMB_BITS);
+    if (words >= size)
+    {
+        mpz_set_si(mpz, negative ? -1 : 0);
+        return *this;
+    }
+
+    mp_limb_t* rp = mpz_limbs_modify(mpz, static_cast<mp_size_t>(size));
+    bool inexact = std::find_if(rp, rp + words, [](mp_limb_t limb) { return limb != 0; }) != rp + words;
+    size_t n = size - static_cast<size_t>(words);
+    if (bits == 0)
+    {
+        std::memmove(rp, rp + words, n * sizeof(mp_limb_t));
+    }
+    else
+    {
+        inexact |= active_limb_kernels().rshift(rp, rp + words, n, bits) != 0;
+    }
+    if (negative && inexact)
+    {
+        size_t i = 0;
+        while (i != n && ++rp[i] == 0)
+        {
+            i++;
+        }
+        if (i == n)
+        {
+            // |x| >> rhs was all ones; words > 0 here, so the buffer has room for the carry
+            rp[n++] = 1;
+        }
+    }
+    while (n != 0 && rp[n - 1] == 0)
+    {
+        n--;
+    }
+    mpz_limbs_finish(mpz, negative ? -static_cast<mp_size_t>(n) : static_cast<mp_size_t>(n));
     return *this;
 }
 
@@ -105,6 +654,7 @@ big_integer big_integer::operator+() const
 
 big_integer big_integer::operator-() const
 {
+    count(big_integer_stats::negate, mpz_size(mpz));
     big_integer r;
     mpz_neg(r.mpz, mpz);
     return r;
@@ -112,6 +662,7 @@ big_integer big_integer::operator-() const
 
 big_integer big_integer::operator~() const
 {
+    count(big_integer_stats::complement, mpz_size(mpz));
     big_integer r;
     mpz_com(r.mpz, mpz);
     return r;
@@ -119,6 +670,7 @@ big_integer big_integer::operator~() const
 
 big_integer& big_integer::operator++()
 {
+    count(big_integer_stats::increment, mpz_size(mpz));
     mpz_add_ui(mpz, mpz, 1);
     return *this;
 }
@@ -132,6 +684,7 @@ big_integer big_integer::operator++(int)
 
 big_integer& big_integer::operator--()
 {
+    count(big_integer_stats::decrement, mpz_size(mpz));
     mpz_sub_ui(mpz, mpz, 1);
     return *this;
 }
@@ -143,97 +696,282 @@ big_integer big_integer::operator--(int)
     return r;
 }
 
+uint64_t const big_integer::npos;
+
+uint64_t big_integer::bit_length() const
+{
+    return mpz_sgn(mpz) == 0 ? 0 : mpz_sizeinbase(mpz, 2);
+}
+
+uint64_t big_integer::popcount() const
+{
+    return mpz_sgn(mpz) == 0 ? 0 : mpn_popcount(mpz_limbs_read(mpz), static_cast<mp_size_t>(mpz_size(mpz)));
+}
+
+uint64_t big_integer::count_trailing_zeros() const
+{
+    mp_limb_t const* limbs = mpz_limbs_read(mpz);
+    size_t size = mpz_size(mpz);
+    for (size_t i = 0; i != size; i++)
+    {
+        if (limbs[i] != 0)
+        {
+            return i * GMP_NUMB_BITS + static_cast<uint64_t>(__builtin_ctzl(limbs[i]));
+        }
+    }
+    return 0;
+}
+
+bool big_integer::test_bit(uint64_t i) const
+{
+    uint64_t word = i / GMP_NUMB_BITS;
+    if (mpz_sgn(mpz) >= 0)
+    {
+        return word < mpz_size(mpz) && ((mpz_getlimbn(mpz, static_cast<mp_size_t>(word)) >> (i % GMP_NUMB_BITS)) & 1) != 0;
+    }
+    return mpz_tstbit(mpz, i) != 0;
+}
+
+void big_integer::set_bit(uint64_t i)
+{
+    uint64_t word = i / GMP_NUMB_BITS;
+    if (mpz_sgn(mpz) > 0 && word < mpz_size(mpz))
+    {
+        mp_size_t size = static_cast<mp_size_t>(mpz_size(mpz));
+        mpz_limbs_modify(mpz, size)[word] |= mp_limb_t(1) << (i % GMP_NUMB_BITS);
+        mpz_limbs_finish(mpz, size);
+        return;
+    }
+    mpz_setbit(mpz, i);
+}
+
+void big_integer::clear_bit(uint64_t i)
+{
+    uint64_t word = i / GMP_NUMB_BITS;
+    if (mpz_sgn(mpz) > 0 && word + 1 < mpz_size(mpz))
+    {
+        mp_size_t size = static_cast<mp_size_t>(mpz_size(mpz));
+        mpz_limbs_modify(mpz, size)[word] &= ~(mp_limb_t(1) << (i % GMP_NUMB_BITS));
+        mpz_limbs_finish(mpz, size);
+        return;
+    }
+    mpz_clrbit(mpz, i);
+}
+
+void big_integer::flip_bit(uint64_t i)
+{
+    uint64_t word = i / GMP_NUMB_BITS;
+    if (mpz_sgn(mpz) > 0 && word + 1 < mpz_size(mpz))
+    {
+        mp_size_t size = static_cast<mp_size_t>(mpz_size(mpz));
+        mpz_limbs_modify(mpz, size)[word] ^= mp_limb_t(1) << (i % GMP_NUMB_BITS);
+        mpz_limbs_finish(mpz, size);
+        return;
+    }
+    mpz_combit(mpz, i);
+}
+
+uint64_t big_integer::scan1(uint64_t from) const
+{
+    return mpz_scan1(mpz, from);
+}
+
+uint64_t big_integer::scan0(uint64_t from) const
+{
+    return mpz_scan0(mpz, from);
+}
+
+size_t big_integer::hash() const
+{
+    return hash_limbs(mpz);
+}
+
+void swap(big_integer& a, big_integer& b)
+{
+    a.swap(b);
+}
+
 big_integer operator+(big_integer a, big_integer const& b)
 {
-    return a += b;
+    a += b;
+    return a;
 }
 
 big_integer operator-(big_integer a, big_integer const& b)
 {
-    return a -= b;
+    a -= b;
+    return a;
 }
 
 big_integer operator*(big_integer a, big_integer const& b)
 {
-    return a *= b;
+    a *= b;
+    return a;
 }
 
 big_integer operator/(big_integer a, big_integer const& b)
 {
-    return a /= b;
+    a /= b;
+    return a;
 }
 
 big_integer operator%(big_integer a, big_integer const& b)
 {
-    return a %= b;
+    a %= b;
+    return a;
 }
 
 big_integer operator&(big_integer a, big_integer const& b)
 {
-    return a &= b;
+    a &= b;
+    return a;
 }
 
 big_integer operator|(big_integer a, big_integer const& b)
 {
-    return a |= b;
+    a |= b;
+    return a;
 }
 
 big_integer operator^(big_integer a, big_integer const& b)
 {
-    return a ^= b;
+    a ^= b;
+    return a;
 }
 
-big_integer operator<<(big_integer a, int b)
+big_integer operator<<(big_integer a, uint64_t b)
 {
-    return a <<= b;
+    a <<= b;
+    return a;
 }
 
-big_integer operator>>(big_integer a, int b)
+big_integer operator>>(big_integer a, uint64_t b)
 {
-    return a >>= b;
+    a >>= b;
+    return a;
 }
 
 bool operator==(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) == 0;
 }
 
 bool operator!=(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) != 0;
 }
 
 bool operator<(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) < 0;
 }
 
 bool operator>(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) > 0;
 }
 
 bool operator<=(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) <= 0;
 }
 
 bool operator>=(big_integer const& a, big_integer const& b)
 {
+    count(big_integer_stats::compare, operand_limbs(a.mpz, b.mpz));
     return mpz_cmp(a.mpz, b.mpz) >= 0;
 }
 
 std::string to_string(big_integer const& a)
 {
-    char* tmp = mpz_get_str(NULL, 10, a.mpz);
-    std::string res = tmp;
+    count(big_integer_stats::to_string, mpz_size(a.mpz));
+    size_t threads = big_integer::concurrency();
+    if (threads < 2 || mpz_size(a.mpz) < thresholds.parallel_to_string)
+    {
+        return get_str(a.mpz);
+    }
 
-    void (*freefunc)(void*, size_t);
-    mp_get_memory_functions (NULL, NULL, &freefunc);
+    mpz_t view;
+    mpz_srcptr magnitude = limb_view(view, a.mpz, 0, mpz_size(a.mpz));
+    size_t bits = mpz_sizeinbase(magnitude, 2);
+    std::deque<mpz_value> powers;
+    push_square(powers);
+    while (2 * mpz_sizeinbase(powers.back().value, 2) - 2 < bits)
+    {
+        push_square(powers);
+    }
+    std::string res = to_string_parallel(magnitude, powers, powers.size() - 1, false, threads);
+    return mpz_sgn(a.mpz) < 0 ? '-' + res : res;
+}
 
-    freefunc(tmp, strlen(tmp) + 1);
+mp_limb_t* big_integer::random_limbs(uint64_t bits)
+{
+    uint64_t n = (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    if (n > static_cast<uint64_t>(std::numeric_limits<int>::max()))
+    {
+        throw std::length_error("big_integer is too large");
+    }
+    return mpz_limbs_write(mpz, n == 0 ? 1 : static_cast<mp_size_t>(n));
+}
 
-    return res;
+void big_integer::finish_random(mp_limb_t* limbs, uint64_t bits)
+{
+    uint64_t n = (bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    if (bits % GMP_NUMB_BITS != 0)
+    {
+        limbs[n - 1] &= (mp_limb_t(1) << (bits % GMP_NUMB_BITS)) - 1;
+    }
+    mpz_limbs_finish(mpz, static_cast<mp_size_t>(n));
+}
+
+void big_integer::check_random_bound(big_integer const& bound)
+{
+    if (mpz_sgn(bound.mpz) <= 0)
+    {
+        throw std::invalid_argument("non-positive bound");
+    }
+}
+
+big_integer_thresholds const& active_big_integer_thresholds()
+{
+    return thresholds;
+}
+
+big_integer_thresholds default_big_integer_thresholds()
+{
+    return {
+        BIGINT_PARALLEL_MUL_THRESHOLD,
+        BIGINT_PARALLEL_TO_STRING_THRESHOLD,
+        BIGINT_PARALLEL_PARSE_THRESHOLD,
+        BIGINT_PARALLEL_TREE_THRESHOLD,
+        BIGINT_PRODUCT_LEAF_LIMBS,
+    };
+}
+
+void set_big_integer_thresholds(big_integer_thresholds const& t)
+{
+    thresholds = t;
+    // the parallel splits need operands of at least two limbs; parsing also falls back
+    // to one piece below its smallest chunk, see parse_parallel
+    thresholds.parallel_mul = std::max<size_t>(thresholds.parallel_mul, 2);
+    thresholds.parallel_to_string = std::max<size_t>(thresholds.parallel_to_string, 2);
+    thresholds.parallel_parse = std::max<size_t>(thresholds.parallel_parse, 2);
+    thresholds.product_leaf_limbs = std::max<size_t>(thresholds.product_leaf_limbs, 2);
+}
+
+void big_integer::set_concurrency(size_t threads)
+{
+    thread_pool::instance().set_concurrency(threads);
+}
+
+size_t big_integer::concurrency()
+{
+    return thread_pool::instance().concurrency();
 }
 
 std::ostream& operator<<(std::ostream& s, big_integer const& a)
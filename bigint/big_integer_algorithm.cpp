@@ -0,0 +1,436 @@
+#include "big_integer_algorithm.h"
+#include "big_integer_thresholds.h"
+#include "limb_kernels.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <gmp.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// Raw access for the algorithms below. Only used to fill big_integers this file has
+// just constructed, so the state a big_integer derives from its value stays valid.
+struct big_integer_access
+{
+    static mpz_ptr mpz(big_integer& a)
+    {
+        return a.mpz;
+    }
+};
+
+namespace
+{
+__extension__ typedef unsigned __int128 uint128_t;
+__extension__ typedef __int128 int128_t;
+
+// odd numbers covered by one sieve segment, sized to stay in L1
+size_t const sieve_segment = 32768;
+
+// primes_up_to keeps tables up to this bound for later calls, about 4 MB of primes;
+// larger ranges are sieved per call and freed with the last result that uses them
+uint64_t const prime_cache_limit = uint64_t(1) << 24;
+
+uint64_t magnitude(uint64_t w)
+{
+    return w;
+}
+
+uint64_t magnitude(int64_t w)
+{
+    return w < 0 ? -static_cast<uint64_t>(w) : static_cast<uint64_t>(w);
+}
+
+bool is_negative(uint64_t)
+{
+    return false;
+}
+
+bool is_negative(int64_t w)
+{
+    return w < 0;
+}
+
+big_integer from_uint128(uint128_t m, bool negative)
+{
+    big_integer r;
+    mpz_ptr z = big_integer_access::mpz(r);
+    mp_limb_t* limbs = mpz_limbs_write(z, 2);
+    limbs[0] = static_cast<mp_limb_t>(m);
+    limbs[1] = static_cast<mp_limb_t>(m >> 64);
+    mp_size_t size = limbs[1] != 0 ? 2 : limbs[0] != 0 ? 1 : 0;
+    mpz_limbs_finish(z, negative ? -size : size);
+    return r;
+}
+
+// combines values[i] with values[i + stride] into values[i] for every level of a
+// balanced binary tree, leaving the result in values[0]; the operands of a level
+// are disjoint, so its pairs can run in parallel
+template<typename Op>
+void reduce_tree(std::vector<big_integer>& values, Op op)
+{
+    size_t n = values.size();
+    size_t threads = big_integer::concurrency();
+    for (size_t stride = 1; stride < n; stride *= 2)
+    {
+        size_t pairs = (n + stride - 1) / (2 * stride);
+        auto step = [&](size_t k) {
+            size_t i = 2 * stride * k;
+            op(values[i], values[i + stride]);
+            big_integer().swap(values[i + stride]);
+        };
+
+        uint64_t bits = 0;
+        for (size_t i = 0; threads >= 2 && pairs >= 2 && i < n; i += stride)
+        {
+            bits += values[i].bit_length();
+        }
+        if (bits / GMP_NUMB_BITS >= active_big_integer_thresholds().parallel_tree)
+        {
+            thread_pool::instance().parallel_for(pairs, step);
+        }
+        else
+        {
+            for (size_t k = 0; k != pairs; k++)
+            {
+                step(k);
+            }
+        }
+    }
+}
+
+// limbs [p, p + size) as a new leaf
+void push_leaf(std::vector<big_integer>& leaves, mp_limb_t const* p, size_t size)
+{
+    leaves.emplace_back();
+    mpz_ptr z = big_integer_access::mpz(leaves.back());
+    std::copy(p, p + size, mpz_limbs_write(z, static_cast<mp_size_t>(size)));
+    mpz_limbs_finish(z, static_cast<mp_size_t>(size));
+}
+
+// The words are multiplied into leaves of about leaf_limbs limbs, two at a time: their
+// product m fits two limbs, and acc * m is one mul_1 row and one addmul_1 row into the
+// other buffer, the schoolbook base case for a two-limb multiplier. Then the leaves go
+// through the product tree.
+template<typename Word>
+big_integer product_words(std::vector<Word> const& words)
+{
+    size_t leaf_limbs = active_big_integer_thresholds().product_leaf_limbs;
+    limb_kernels const& kernels = active_limb_kernels();
+    std::vector<big_integer> leaves;
+    leaves.reserve(words.size() / (leaf_limbs - 1) + 1);
+    // acc holds size limbs, below leaf_limbs before each multiplication
+    std::vector<mp_limb_t> acc(leaf_limbs + 2), next(leaf_limbs + 2);
+    acc[0] = 1;
+    size_t size = 1;
+    bool negative = false;
+    for (size_t i = 0; i < words.size(); i += 2)
+    {
+        uint128_t m = magnitude(words[i]);
+        negative ^= is_negative(words[i]);
+        if (i + 1 != words.size())
+        {
+            m *= magnitude(words[i + 1]);
+            negative ^= is_negative(words[i + 1]);
+        }
+        if (m == 0)
+        {
+            return 0;
+        }
+        mp_limb_t high = static_cast<mp_limb_t>(m >> 64);
+        next[size] = kernels.mul_1(next.data(), acc.data(), size, static_cast<mp_limb_t>(m));
+        size_t next_size = size + 1;
+        if (high != 0)
+        {
+            next[size + 1] = kernels.addmul_1(next.data() + 1, acc.data(), size, high);
+            next_size++;
+        }
+        while (next[next_size - 1] == 0)
+        {
+            next_size--;
+        }
+        acc.swap(next);
+        size = next_size;
+        if (size >= leaf_limbs)
+        {
+            push_leaf(leaves, acc.data(), size);
+            acc[0] = 1;
+            size = 1;
+        }
+    }
+    push_leaf(leaves, acc.data(), size);
+
+    big_integer r = big_integer_detail::product(std::move(leaves));
+    if (negative)
+    {
+        mpz_neg(big_integer_access::mpz(r), big_integer_access::mpz(r));
+    }
+    return r;
+}
+
+struct prime_table
+{
+    uint64_t limit;
+    std::vector<uint32_t> primes;
+};
+
+// all primes <= n; only the odd numbers are sieved, `segment` of them at a time
+std::shared_ptr<prime_table const> sieve(uint64_t n, size_t segment = sieve_segment)
+{
+    std::shared_ptr<prime_table> table = std::make_shared<prime_table>();
+    table->limit = n;
+    std::vector<uint32_t>& primes = table->primes;
+    if (n < 2)
+    {
+        return table;
+    }
+    primes.reserve(static_cast<size_t>(1.25 * n / std::log(static_cast<double>(n))) + 1);
+    primes.push_back(2);
+
+    uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (root * root > n)
+    {
+        root--;
+    }
+    while ((root + 1) * (root + 1) <= n)
+    {
+        root++;
+    }
+    std::vector<bool> small_composite(root + 1);
+    std::vector<uint64_t> base;
+    for (uint64_t p = 3; p <= root; p += 2)
+    {
+        if (!small_composite[p])
+        {
+            base.push_back(p);
+            for (uint64_t j = p * p; j <= root; j += 2 * p)
+            {
+                small_composite[j] = true;
+            }
+        }
+    }
+
+    // next[i] is the next odd multiple of base[i] still to be struck out
+    std::vector<uint64_t> next(base.size());
+    for (size_t i = 0; i != base.size(); i++)
+    {
+        next[i] = base[i] * base[i];
+    }
+    std::vector<char> composite(segment);
+    for (uint64_t low = 3; low <= n; low += 2 * segment)
+    {
+        uint64_t high = std::min(low + 2 * segment, n + 1);
+        std::fill(composite.begin(), composite.end(), 0);
+        // next[i] only orders the primes up to the first square past the segment: a
+        // smaller prime's next multiple may already lie beyond high while a larger
+        // prime still has one inside, so that case must not end the loop
+        for (size_t i = 0; i != base.size() && base[i] * base[i] < high; i++)
+        {
+            uint64_t j = next[i];
+            for (; j < high; j += 2 * base[i])
+            {
+                composite[(j - low) / 2] = 1;
+            }
+            next[i] = j;
+        }
+        for (uint64_t k = low; k < high; k += 2)
+        {
+            if (!composite[(k - low) / 2])
+            {
+                primes.push_back(static_cast<uint32_t>(k));
+            }
+        }
+    }
+    return table;
+}
+
+// the largest table sieved so far, up to prime_cache_limit, serves every smaller request
+std::shared_ptr<prime_table const> primes_up_to(uint64_t n)
+{
+    if (n > UINT32_MAX)
+    {
+        throw std::length_error("argument too large");
+    }
+    if (n > prime_cache_limit)
+    {
+        return sieve(n);
+    }
+    static std::mutex mutex;
+    static std::shared_ptr<prime_table const> cache;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache && cache->limit >= n)
+        {
+            return cache;
+        }
+    }
+    std::shared_ptr<prime_table const> table = sieve(n);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!cache || cache->limit < n)
+    {
+        cache = table;
+    }
+    return table;
+}
+
+std::vector<uint32_t>::const_iterator primes_end(prime_table const& table, uint64_t n)
+{
+    return std::upper_bound(table.primes.begin(), table.primes.end(), n);
+}
+
+// exponent of p in n! (Legendre)
+uint64_t legendre(uint64_t n, uint64_t p)
+{
+    uint64_t e = 0;
+    while (n != 0)
+    {
+        n /= p;
+        e += n;
+    }
+    return e;
+}
+
+uint64_t power(uint64_t p, uint64_t e)
+{
+    uint64_t r = 1;
+    for (; e != 0; e--)
+    {
+        r *= p;
+    }
+    return r;
+}
+
+// odd part of n! / ((n / 2)!)^2: the exponent of an odd prime p in it is the sum
+// of (n / p^i) mod 2, and that power of p never exceeds n, so each factor is a word
+big_integer odd_swing(uint64_t n, prime_table const& table)
+{
+    std::vector<uint64_t> factors;
+    for (auto it = table.primes.begin() + 1, end = primes_end(table, n); it < end; ++it)
+    {
+        uint64_t p = *it;
+        uint64_t factor = 1;
+        for (uint64_t q = n / p; q != 0; q /= p)
+        {
+            if (q & 1)
+            {
+                factor *= p;
+            }
+        }
+        if (factor != 1)
+        {
+            factors.push_back(factor);
+        }
+    }
+    return big_integer_detail::product(factors);
+}
+
+// odd part of n!, which is odd_factorial(n / 2)^2 * odd_swing(n)
+big_integer odd_factorial(uint64_t n, prime_table const& table)
+{
+    if (n < 3)
+    {
+        return 1;
+    }
+    big_integer r = odd_factorial(n / 2, table);
+    r *= r;
+    r *= odd_swing(n, table);
+    return r;
+}
+}
+
+namespace big_integer_detail
+{
+big_integer product(std::vector<big_integer> values)
+{
+    big_integer r = 1;
+    if (!values.empty())
+    {
+        reduce_tree(values, [](big_integer& a, big_integer const& b) { a *= b; });
+        r.swap(values[0]);
+    }
+    return r;
+}
+
+big_integer product(std::vector<int64_t> const& words)
+{
+    return product_words(words);
+}
+
+big_integer product(std::vector<uint64_t> const& words)
+{
+    return product_words(words);
+}
+
+big_integer sum(std::vector<big_integer> values)
+{
+    big_integer r;
+    if (!values.empty())
+    {
+        reduce_tree(values, [](big_integer& a, big_integer const& b) { a += b; });
+        r.swap(values[0]);
+    }
+    return r;
+}
+
+// words cannot overflow 128 bits before memory runs out, one pass is enough
+big_integer sum(std::vector<int64_t> const& words)
+{
+    int128_t s = 0;
+    for (int64_t w : words)
+    {
+        s += w;
+    }
+    return from_uint128(s < 0 ? -static_cast<uint128_t>(s) : static_cast<uint128_t>(s), s < 0);
+}
+
+big_integer sum(std::vector<uint64_t> const& words)
+{
+    uint128_t s = 0;
+    for (uint64_t w : words)
+    {
+        s += w;
+    }
+    return from_uint128(s, false);
+}
+
+std::vector<uint32_t> primes(uint64_t n, size_t segment)
+{
+    return sieve(n, segment)->primes;
+}
+}
+
+big_integer factorial(uint64_t n)
+{
+    std::shared_ptr<prime_table const> table = primes_up_to(n);
+    return odd_factorial(n, *table) << (n - static_cast<uint64_t>(__builtin_popcountll(n)));
+}
+
+big_integer binomial(uint64_t n, uint64_t k)
+{
+    if (k > n)
+    {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    std::shared_ptr<prime_table const> table = primes_up_to(n);
+    std::vector<uint64_t> factors;
+    for (auto it = table->primes.begin(), end = primes_end(*table, n); it < end; ++it)
+    {
+        uint64_t p = *it;
+        // Kummer: p^e divides C(n, k) with p^e <= n, so the factor is one word
+        uint64_t e = p > n - k ? 1 : legendre(n, p) - legendre(k, p) - legendre(n - k, p);
+        if (e != 0)
+        {
+            factors.push_back(power(p, e));
+        }
+    }
+    return big_integer_detail::product(factors);
+}
+
+big_integer primorial(uint64_t n)
+{
+    std::shared_ptr<prime_table const> table = primes_up_to(n);
+    return big_integer_detail::product(std::vector<uint64_t>(table->primes.begin(), primes_end(*table, n)));
+}
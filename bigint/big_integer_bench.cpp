@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "big_integer.h"
+#include "big_integer_gmp.h"
+#include "fixed_integer.h"
+
+// every heap allocation of the process: operator new and GMP's allocator
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+// chain to the functions installed before main, e.g. the BIGINT_STATS hooks
+void* (*next_gmp_alloc)(size_t);
+void* (*next_gmp_realloc)(void*, size_t, size_t);
+void (*next_gmp_free)(void*, size_t);
+
+void* counting_gmp_alloc(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return next_gmp_alloc(size);
+}
+
+void* counting_gmp_realloc(void* p, size_t old_size, size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return next_gmp_realloc(p, old_size, size);
+}
+
+void counting_gmp_free(void* p, size_t size) {
+  next_gmp_free(p, size);
+}
+
+template<typename T>
+void do_not_optimize(T const& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct sample {
+  double ns;
+  double allocs;
+};
+
+// runs f until at least min_time has passed, returns the cost of one call
+template<typename F>
+sample measure(F&& f) {
+  using clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds const min_time = std::chrono::milliseconds(100);
+  size_t iterations = 1;
+  for (;;) {
+    size_t allocated = allocations.load(std::memory_order_relaxed);
+    auto start = clock::now();
+    for (size_t i = 0; i != iterations; ++i)
+      f();
+    auto elapsed = clock::now() - start;
+    if (elapsed >= min_time)
+      return {std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+              static_cast<double>(allocations.load(std::memory_order_relaxed) - allocated) / iterations};
+    iterations *= 2;
+  }
+}
+
+struct record {
+  std::string suite, op;
+  size_t bits;
+  sample result;
+  double baseline_ns;
+};
+
+std::vector<record> records;
+
+// baseline_ns is the big_integer_gmp time for the same operation, 0 if there is none
+void report(char const* suite, std::string const& op, size_t bits, sample result, double baseline_ns = 0) {
+  std::printf("%-8s %-26s %10zu bits %14.1f ns/op %8.2f allocs/op", suite, op.c_str(), bits, result.ns, result.allocs);
+  if (baseline_ns != 0)
+    std::printf(" %7.2fx gmp", result.ns / baseline_ns);
+  std::printf("\n");
+  std::fflush(stdout);
+  records.push_back({suite, op, bits, result, baseline_ns});
+}
+
+template<size_t Bits>
+void bench_fixed(std::default_random_engine& rng) {
+  big_integer_gmp ga, gb;
+  ga.random(Bits / 2 - 2, rng);
+  gb.random(Bits / 4, rng);
+  big_integer a(to_string(ga)), b(to_string(gb));
+  fixed_integer<Bits> x(a), y(b);
+
+  report("fixed", "fixed_integer +", Bits, measure([&] { do_not_optimize(x + y); }));
+  report("fixed", "big_integer +", Bits, measure([&] { do_not_optimize(a + b); }));
+  report("fixed", "fixed_integer *", Bits, measure([&] { do_not_optimize(x * y); }));
+  report("fixed", "big_integer *", Bits, measure([&] { do_not_optimize(a * b); }));
+  report("fixed", "fixed_integer /", Bits, measure([&] { do_not_optimize(x / y); }));
+  report("fixed", "big_integer /", Bits, measure([&] { do_not_optimize(a / b); }));
+  report("fixed", "fixed_integer to_string", Bits, measure([&] { do_not_optimize(to_string(x)); }));
+  report("fixed", "big_integer to_string", Bits, measure([&] { do_not_optimize(to_string(a)); }));
+}
+
+void run_fixed() {
+  std::default_random_engine rng(42);
+  bench_fixed<128>(rng);
+  bench_fixed<256>(rng);
+  bench_fixed<512>(rng);
+  bench_fixed<1024>(rng);
+}
+
+// multiplication of two 100000-limb numbers and decimal conversion of one of them
+// for every thread count up to max_threads
+void run_threads() {
+  std::default_random_engine rng(42);
+  big_integer_gmp ga, gb;
+  ga.random(100000 * 64, rng);
+  gb.random(100000 * 64, rng);
+  big_integer a(to_string(ga)), b(to_string(gb));
+
+  size_t concurrency = big_integer::concurrency();
+  size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+  for (size_t threads = 1; threads <= max_threads; ++threads) {
+    big_integer::set_concurrency(threads);
+    char op[32];
+    std::snprintf(op, sizeof op, "* %zu threads", threads);
+    report("threads", op, 100000 * 64, measure([&] { do_not_optimize(a * b); }));
+    std::snprintf(op, sizeof op, "to_string %zu threads", threads);
+    report("threads", op, 100000 * 64, measure([&] { do_not_optimize(to_string(a)); }));
+    std::string str = to_string(a);
+    std::snprintf(op, sizeof op, "parse %zu threads", threads);
+    report("threads", op, 100000 * 64, measure([&] { do_not_optimize(big_integer(str)); }));
+  }
+  big_integer::set_concurrency(concurrency);
+}
+
+// one operation on big_integer_gmp and on big_integer, the former being the baseline
+template<typename F, typename G>
+void compare(char const* op, size_t bits, F&& gmp, G&& ours) {
+  sample baseline = measure(gmp);
+  report("ops", std::string("big_integer_gmp ") + op, bits, baseline);
+  report("ops", std::string("big_integer ") + op, bits, measure(ours), baseline.ns);
+}
+
+// every operator on n-limb operands; the dividend has 2n limbs
+void bench_ops(size_t limbs, std::mt19937_64& rng) {
+  size_t const bits = limbs * 64;
+  big_integer a = big_integer::random_bits(bits, rng), b = big_integer::random_bits(bits, rng);
+  big_integer d = big_integer::random_bits(2 * bits, rng);
+  a.set_bit(bits - 1);
+  b.set_bit(bits - 1);
+  std::string str = to_string(a);
+  big_integer_gmp ga(str), gb(to_string(b)), gd(to_string(d));
+
+  compare("+", bits, [&] { do_not_optimize(ga + gb); }, [&] { do_not_optimize(a + b); });
+  compare("-", bits, [&] { do_not_optimize(ga - gb); }, [&] { do_not_optimize(a - b); });
+  compare("*", bits, [&] { do_not_optimize(ga * gb); }, [&] { do_not_optimize(a * b); });
+  compare("/", bits, [&] { do_not_optimize(gd / gb); }, [&] { do_not_optimize(d / b); });
+  compare("%", bits, [&] { do_not_optimize(gd % gb); }, [&] { do_not_optimize(d % b); });
+  compare("<< 67", bits, [&] { do_not_optimize(ga << 67); }, [&] { do_not_optimize(a << 67); });
+  compare(">> 67", bits, [&] { do_not_optimize(ga >> 67); }, [&] { do_not_optimize(a >> 67); });
+  compare("&", bits, [&] { do_not_optimize(ga & gb); }, [&] { do_not_optimize(a & b); });
+  compare("|", bits, [&] { do_not_optimize(ga | gb); }, [&] { do_not_optimize(a | b); });
+  compare("^", bits, [&] { do_not_optimize(ga ^ gb); }, [&] { do_not_optimize(a ^ b); });
+  compare("to_string", bits, [&] { do_not_optimize(to_string(ga)); }, [&] { do_not_optimize(to_string(a)); });
+  compare("parse", bits, [&] { do_not_optimize(big_integer_gmp(str)); }, [&] { do_not_optimize(big_integer(str)); });
+  compare("copy", bits, [&] { do_not_optimize(big_integer_gmp(ga)); }, [&] { do_not_optimize(big_integer(a)); });
+}
+
+// operand sizes from 1 limb up to max_limbs in steps of 10
+void run_ops(size_t max_limbs) {
+  std::mt19937_64 rng(42);
+  for (size_t limbs = 1; limbs <= max_limbs; limbs *= 10)
+    bench_ops(limbs, rng);
+}
+
+void write_json(char const* path) {
+  std::FILE* f = std::fopen(path, "w");
+  if (!f) {
+    std::perror(path);
+    return;
+  }
+  std::fprintf(f, "[\n");
+  for (size_t i = 0; i != records.size(); ++i) {
+    record const& r = records[i];
+    std::fprintf(f, "  {\"library\": \"%s\", \"suite\": \"%s\", \"op\": \"%s\", \"bits\": %zu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f",
+                 BIGINT_LIBRARY, r.suite.c_str(), r.op.c_str(), r.bits, r.result.ns, r.result.allocs);
+    if (r.baseline_ns != 0)
+      std::fprintf(f, ", \"baseline_ns_per_op\": %.1f", r.baseline_ns);
+    std::fprintf(f, "}%s\n", i + 1 == records.size() ? "" : ",");
+  }
+  std::fprintf(f, "]\n");
+  std::fclose(f);
+}
+
+std::vector<std::string> suites;
+
+bool selected(char const* suite) {
+  return suites.empty() || std::find(suites.begin(), suites.end(), suite) != suites.end();
+}
+}
+
+// usage: big_integer_bench [--json=FILE] [--max-limbs=N] [suite...]
+// suites are fixed, threads and ops; all of them run when none is given
+int main(int argc, char** argv) {
+  mp_get_memory_functions(&next_gmp_alloc, &next_gmp_realloc, &next_gmp_free);
+  mp_set_memory_functions(counting_gmp_alloc, counting_gmp_realloc, counting_gmp_free);
+
+  char const* json = nullptr;
+  size_t max_limbs = 1000000;
+  for (int i = 1; i != argc; ++i) {
+    if (std::strncmp(argv[i], "--json=", 7) == 0)
+      json = argv[i] + 7;
+    else if (std::strncmp(argv[i], "--max-limbs=", 12) == 0)
+      max_limbs = std::strtoull(argv[i] + 12, nullptr, 10);
+    else
+      suites.push_back(argv[i]);
+  }
+
+  if (selected("fixed"))
+    run_fixed();
+  if (selected("threads"))
+    run_threads();
+  if (selected("ops"))
+    run_ops(max_limbs);
+  if (json)
+    write_json(json);
+  return 0;
+}
@@ -0,0 +1,221 @@
+#include "big_integer_stats.h"
+
+#include <algorithm>
+#include <gmp.h>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+char const* const event_names[big_integer_stats::event_count] = {
+    "constructions", "copies", "moves", "allocations", "frees", "bytes allocated"};
+
+char const* const operation_names[big_integer_stats::operation_count] = {
+    "+", "-", "*", "/", "%", "&", "|", "^", "<<", ">>",
+    "unary -", "~", "++", "--", "compare", "to_string", "parse"};
+
+// blocks of live threads, and the sum of the blocks of threads that have exited
+struct registry
+{
+    std::mutex mutex;
+    std::vector<big_integer_stats_detail::counters*> live;
+    big_integer_stats::snapshot retired = {};
+};
+
+registry& get_registry()
+{
+    static registry r;
+    return r;
+}
+
+void add_to(big_integer_stats::snapshot& s, big_integer_stats_detail::counters const& c)
+{
+    for (size_t e = 0; e != big_integer_stats::event_count; e++)
+    {
+        s.events[e] += c.events[e].load(std::memory_order_relaxed);
+    }
+    for (size_t op = 0; op != big_integer_stats::operation_count; op++)
+    {
+        for (size_t b = 0; b != big_integer_stats::buckets; b++)
+        {
+            s.calls[op][b] += c.calls[op][b].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void clear(big_integer_stats_detail::counters& c)
+{
+    for (std::atomic<uint64_t>& e : c.events)
+    {
+        e.store(0, std::memory_order_relaxed);
+    }
+    for (auto& op : c.calls)
+    {
+        for (std::atomic<uint64_t>& b : op)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// trivially destructible, so it can still be read while the thread is torn down
+thread_local bool exited = false;
+
+struct registration
+{
+    registration()
+    {
+        clear(counters);
+        registry& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(&counters);
+    }
+
+    ~registration()
+    {
+        exited = true;
+        registry& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        add_to(r.retired, counters);
+        r.live.erase(std::find(r.live.begin(), r.live.end(), &counters));
+    }
+
+    big_integer_stats_detail::counters counters;
+};
+
+#ifdef BIGINT_STATS
+void* (*next_alloc)(size_t);
+void* (*next_realloc)(void*, size_t, size_t);
+void (*next_free)(void*, size_t);
+
+void* counting_alloc(size_t size)
+{
+    big_integer_stats_detail::count(big_integer_stats::allocations);
+    big_integer_stats_detail::count(big_integer_stats::bytes_allocated, size);
+    return next_alloc(size);
+}
+
+void* counting_realloc(void* p, size_t old_size, size_t new_size)
+{
+    big_integer_stats_detail::count(big_integer_stats::allocations);
+    big_integer_stats_detail::count(big_integer_stats::frees);
+    big_integer_stats_detail::count(big_integer_stats::bytes_allocated, new_size);
+    return next_realloc(p, old_size, new_size);
+}
+
+void counting_free(void* p, size_t size)
+{
+    big_integer_stats_detail::count(big_integer_stats::frees);
+    next_free(p, size);
+}
+
+// chains to whatever allocator was installed before static initialization ran
+struct install_memory_hooks
+{
+    install_memory_hooks()
+    {
+        mp_get_memory_functions(&next_alloc, &next_realloc, &next_free);
+        mp_set_memory_functions(counting_alloc, counting_realloc, counting_free);
+    }
+} const memory_hooks;
+#endif
+}
+
+big_integer_stats_detail::counters& big_integer_stats_detail::local()
+{
+    // events after the thread's block is gone (e.g. from destructors of statics)
+    // are dropped here
+    static counters late;
+    if (exited)
+    {
+        return late;
+    }
+    thread_local registration r;
+    return r.counters;
+}
+
+bool big_integer_stats::enabled()
+{
+#ifdef BIGINT_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+big_integer_stats::snapshot big_integer_stats::collect()
+{
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    snapshot s = r.retired;
+    for (big_integer_stats_detail::counters const* c : r.live)
+    {
+        add_to(s, *c);
+    }
+    return s;
+}
+
+void big_integer_stats::reset()
+{
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = snapshot();
+    for (big_integer_stats_detail::counters* c : r.live)
+    {
+        clear(*c);
+    }
+}
+
+void big_integer_stats::dump(std::ostream& out)
+{
+    if (!enabled())
+    {
+        out << "big_integer statistics are disabled, configure with -DBIGINT_STATS=ON\n";
+        return;
+    }
+    snapshot s = collect();
+    out << "big_integer statistics\n";
+    for (size_t e = 0; e != event_count; e++)
+    {
+        if (s.events[e] != 0)
+        {
+            out << "  " << event_names[e] << ": " << s.events[e] << '\n';
+        }
+    }
+    for (size_t op = 0; op != operation_count; op++)
+    {
+        uint64_t total = 0;
+        for (uint64_t calls : s.calls[op])
+        {
+            total += calls;
+        }
+        if (total == 0)
+        {
+            continue;
+        }
+        out << "  " << operation_names[op] << ": " << total << " calls, by limbs";
+        for (size_t b = 0; b != buckets; b++)
+        {
+            if (s.calls[op][b] == 0)
+            {
+                continue;
+            }
+            if (b == 0)
+            {
+                out << " [0]";
+            }
+            else
+            {
+                out << " [" << (uint64_t(1) << (b - 1)) << ", " << (uint64_t(1) << b) << ")";
+            }
+            out << " " << s.calls[op][b];
+        }
+        out << '\n';
+    }
+}
+
+void big_integer_stats::dump()
+{
+    dump(std::cerr);
+}
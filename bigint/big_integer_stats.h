@@ -0,0 +1,99 @@
+#ifndef BIG_INTEGER_STATS_H
+#define BIG_INTEGER_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Counters compiled into big_integer when the build is configured with
+// -DBIGINT_STATS=ON. Every thread counts into its own block without locking;
+// collect() adds up the blocks of live and finished threads. Heap traffic is
+// observed through GMP's memory functions, so it covers every mpz in the process.
+// Without the option the hooks below are empty inline functions and collect()
+// returns zeros.
+struct big_integer_stats
+{
+    enum event
+    {
+        constructions,
+        copies,
+        moves,
+        allocations,
+        frees,
+        bytes_allocated,
+        event_count
+    };
+
+    enum operation
+    {
+        add, sub, mul, div, mod,
+        bit_and, bit_or, bit_xor, shl, shr,
+        negate, complement, increment, decrement,
+        compare, to_string, parse,
+        operation_count
+    };
+
+    // bucket 0 counts calls on zero-limb operands, bucket i > 0 calls whose larger
+    // operand has [2^(i-1), 2^i) limbs
+    static size_t const buckets = 32;
+
+    struct snapshot
+    {
+        uint64_t events[event_count];
+        uint64_t calls[operation_count][buckets];
+    };
+
+    static bool enabled();
+    static snapshot collect();
+    static void reset();
+
+    // human-readable summary of collect(), one line per counter that is not zero
+    static void dump(std::ostream& out);
+    static void dump();
+};
+
+namespace big_integer_stats_detail
+{
+struct counters
+{
+    std::atomic<uint64_t> events[big_integer_stats::event_count];
+    std::atomic<uint64_t> calls[big_integer_stats::operation_count][big_integer_stats::buckets];
+};
+
+// the calling thread's block, registered on first use
+counters& local();
+
+inline void bump(std::atomic<uint64_t>& c, uint64_t by)
+{
+    // only the owning thread writes, readers merely need untorn values
+    c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+inline void count(big_integer_stats::event e, uint64_t by = 1)
+{
+#ifdef BIGINT_STATS
+    bump(local().events[e], by);
+#else
+    (void)e;
+    (void)by;
+#endif
+}
+
+inline void count(big_integer_stats::operation op, size_t limbs)
+{
+#ifdef BIGINT_STATS
+    size_t bucket = 0;
+    for (; limbs != 0; limbs >>= 1)
+    {
+        bucket++;
+    }
+    bump(local().calls[op][bucket], 1);
+#else
+    (void)op;
+    (void)limbs;
+#endif
+}
+}
+
+#endif // BIG_INTEGER_STATS_H
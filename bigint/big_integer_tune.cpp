@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "big_integer.h"
+#include "big_integer_algorithm.h"
+#include "big_integer_thresholds.h"
+
+namespace {
+size_t const never = SIZE_MAX;
+
+// exactly `bits` long, so an operation on it reaches a threshold of bits / 64 limbs
+big_integer random_exact(size_t bits, std::mt19937_64& rng) {
+  big_integer r = big_integer::random_bits(bits, rng);
+  r.set_bit(bits - 1);
+  return r;
+}
+
+template<typename T>
+void do_not_optimize(T const& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// best of three rounds of at least 20 ms each, in ns per call
+double measure(std::function<void()> const& f) {
+  using clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds const min_time = std::chrono::milliseconds(20);
+  double best = 0;
+  for (int round = 0; round != 3; ++round) {
+    size_t iterations = 0;
+    auto start = clock::now();
+    auto elapsed = clock::now() - start;
+    do {
+      f();
+      ++iterations;
+      elapsed = clock::now() - start;
+    } while (elapsed < min_time);
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    best = round == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+// runs f with one threshold changed
+double measure_with(size_t big_integer_thresholds::*field, size_t value, std::function<void()> const& f) {
+  big_integer_thresholds t = active_big_integer_thresholds();
+  t.*field = value;
+  set_big_integer_thresholds(t);
+  return measure(f);
+}
+
+// Smallest size from which splitting the operation once (threshold == size)
+// beats running it whole, at that size and every larger one. Sizes are walked
+// downwards so a host where splitting never pays costs one measurement.
+size_t crossover(char const* name, size_t big_integer_thresholds::*field, std::vector<size_t> const& sizes,
+                 std::function<std::function<void()>(size_t)> const& make_op) {
+  size_t result = never;
+  for (auto it = sizes.rbegin(); it != sizes.rend(); ++it) {
+    std::function<void()> op = make_op(*it);
+    double whole = measure_with(field, never, op);
+    double split = measure_with(field, *it, op);
+    std::fprintf(stderr, "%-10s %9zu: %12.0f ns whole, %12.0f ns split\n", name, *it, whole, split);
+    if (split >= whole)
+      break;
+    result = *it;
+  }
+  return result;
+}
+
+std::vector<size_t> doubling(size_t from, size_t to) {
+  std::vector<size_t> sizes;
+  for (size_t s = from; s <= to; s *= 2)
+    sizes.push_back(s);
+  return sizes;
+}
+
+void print_threshold(std::FILE* out, char const* macro, size_t value) {
+  if (value == never)
+    std::fprintf(out, "#define %s SIZE_MAX\n", macro);
+  else
+    std::fprintf(out, "#define %s %zu\n", macro, value);
+}
+}
+
+// usage: big_integer_tune [--threads=N] [OUTPUT]
+// Measures the crossovers of big_integer_thresholds on this machine with N threads
+// (all hardware threads by default) and writes them as bigint_thresholds.h to
+// OUTPUT, or to stdout; progress goes to stderr. `make tune` stores it where the build picks it up.
+int main(int argc, char** argv) {
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  char const* output = nullptr;
+  for (int i = 1; i != argc; ++i) {
+    if (std::strncmp(argv[i], "--threads=", 10) == 0)
+      threads = std::strtoull(argv[i] + 10, nullptr, 10);
+    else
+      output = argv[i];
+  }
+
+  std::mt19937_64 rng(42);
+  big_integer_thresholds tuned = default_big_integer_thresholds();
+  set_big_integer_thresholds(tuned);
+
+  // the serial choice among leaf sizes, then the parallel crossovers on top of it
+  big_integer::set_concurrency(1);
+  std::vector<uint64_t> words(200000);
+  for (uint64_t& w : words)
+    w = rng() | 1;
+  double best = 0;
+  for (size_t leaf : {4, 8, 16, 32, 64, 128}) {
+    double ns = measure_with(&big_integer_thresholds::product_leaf_limbs, leaf,
+                             [&] { do_not_optimize(product(words.begin(), words.end())); });
+    std::fprintf(stderr, "%-10s %9zu: %12.0f ns\n", "leaf", leaf, ns);
+    if (best == 0 || ns < best) {
+      best = ns;
+      tuned.product_leaf_limbs = leaf;
+    }
+  }
+  set_big_integer_thresholds(tuned);
+
+  big_integer::set_concurrency(threads);
+  if (threads >= 2) {
+    tuned.parallel_mul = crossover("mul", &big_integer_thresholds::parallel_mul, doubling(500, 64000), [&](size_t limbs) {
+      auto a = std::make_shared<big_integer>(random_exact(limbs * 64, rng));
+      auto b = std::make_shared<big_integer>(random_exact(limbs * 64, rng));
+      return [a, b] { do_not_optimize(*a * *b); };
+    });
+    set_big_integer_thresholds(tuned);
+    tuned.parallel_to_string = crossover("to_string", &big_integer_thresholds::parallel_to_string, doubling(500, 32000), [&](size_t limbs) {
+      auto a = std::make_shared<big_integer>(random_exact(limbs * 64, rng));
+      return [a] { do_not_optimize(to_string(*a)); };
+    });
+    set_big_integer_thresholds(tuned);
+    tuned.parallel_parse = crossover("parse", &big_integer_thresholds::parallel_parse, doubling(10000, 1280000), [&](size_t digits) {
+      auto str = std::make_shared<std::string>(digits, '0');
+      for (char& c : *str)
+        c = static_cast<char>('0' + rng() % 10);
+      (*str)[0] = '1';
+      return [str] { do_not_optimize(big_integer(*str)); };
+    });
+    set_big_integer_thresholds(tuned);
+    tuned.parallel_tree = crossover("tree", &big_integer_thresholds::parallel_tree, doubling(500, 64000), [&](size_t limbs) {
+      auto values = std::make_shared<std::vector<big_integer>>();
+      for (int i = 0; i != 16; ++i)
+        values->push_back(random_exact(limbs * 64 / 16, rng));
+      return [values] { do_not_optimize(product(values->begin(), values->end())); };
+    });
+  } else {
+    // no split point was measured, so the header claims none
+    std::fprintf(stderr, "one thread: the parallel paths are never taken, writing SIZE_MAX\n");
+    tuned.parallel_mul = never;
+    tuned.parallel_to_string = never;
+    tuned.parallel_parse = never;
+    tuned.parallel_tree = never;
+  }
+
+  std::FILE* out = output ? std::fopen(output, "w") : stdout;
+  if (!out) {
+    std::perror(output);
+    return 1;
+  }
+  std::fprintf(out, "#ifndef BIGINT_THRESHOLDS_H\n#define BIGINT_THRESHOLDS_H\n\n");
+  std::fprintf(out, "// Generated by big_integer_tune with %zu threads.\n\n#include <cstdint>\n\n", threads);
+  print_threshold(out, "BIGINT_PARALLEL_MUL_THRESHOLD", tuned.parallel_mul);
+  print_threshold(out, "BIGINT_PARALLEL_TO_STRING_THRESHOLD", tuned.parallel_to_string);
+  print_threshold(out, "BIGINT_PARALLEL_PARSE_THRESHOLD", tuned.parallel_parse);
+  print_threshold(out, "BIGINT_PARALLEL_TREE_THRESHOLD", tuned.parallel_tree);
+  print_threshold(out, "BIGINT_PRODUCT_LEAF_LIMBS", tuned.product_leaf_limbs);
+  std::fprintf(out, "\n#endif // BIGINT_THRESHOLDS_H\n");
+  if (output) {
+    std::fclose(out);
+    std::fprintf(stderr, "wrote %s\n", output);
+  }
+  return 0;
+}
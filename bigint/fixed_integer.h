@@ -0,0 +1,743 @@
+#ifndef FIXED_INTEGER_H
+#define FIXED_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "big_integer.h"
+
+static_assert(GMP_NUMB_BITS == 64, "fixed_integer limbs must match GMP limbs");
+
+// Stack-allocated integer of exactly Bits bits. Arithmetic wraps modulo 2^Bits,
+// signed values use two's complement (like the bitwise ops of big_integer).
+// Everything except string and big_integer conversions is constexpr.
+
+namespace fixed_integer_detail
+{
+using limb_t = uint64_t;
+__extension__ typedef unsigned __int128 dlimb_t;
+
+template<char... Chars>
+struct literal;
+
+// r[0..K) += b[0..K) + carry, unrolled by template recursion
+template<size_t K>
+struct add_n
+{
+    static constexpr void run(limb_t* r, limb_t const* b, limb_t carry)
+    {
+        dlimb_t s = static_cast<dlimb_t>(*r) + *b + carry;
+        *r = static_cast<limb_t>(s);
+        add_n<K - 1>::run(r + 1, b + 1, static_cast<limb_t>(s >> 64));
+    }
+};
+
+template<>
+struct add_n<0>
+{
+    static constexpr void run(limb_t*, limb_t const*, limb_t) {}
+};
+
+// r[0..K) -= b[0..K) + borrow
+template<size_t K>
+struct sub_n
+{
+    static constexpr void run(limb_t* r, limb_t const* b, limb_t borrow)
+    {
+        dlimb_t d = static_cast<dlimb_t>(*r) - *b - borrow;
+        *r = static_cast<limb_t>(d);
+        sub_n<K - 1>::run(r + 1, b + 1, static_cast<limb_t>(d >> 127));
+    }
+};
+
+template<>
+struct sub_n<0>
+{
+    static constexpr void run(limb_t*, limb_t const*, limb_t) {}
+};
+
+// r[0..K) += x * b[0..K), the carry out of the last limb is dropped
+template<size_t K>
+struct addmul_row
+{
+    static constexpr void run(limb_t* r, limb_t x, limb_t const* b, limb_t carry)
+    {
+        dlimb_t p = static_cast<dlimb_t>(x) * *b + *r + carry;
+        *r = static_cast<limb_t>(p);
+        addmul_row<K - 1>::run(r + 1, x, b + 1, static_cast<limb_t>(p >> 64));
+    }
+};
+
+template<>
+struct addmul_row<0>
+{
+    static constexpr void run(limb_t*, limb_t, limb_t const*, limb_t) {}
+};
+
+// r[0..N) = a[0..N) * b[0..N) mod 2^(64 N), row I multiplies a[I] by the low N - I limbs of b
+template<size_t I, size_t N>
+struct mul_rows
+{
+    static constexpr void run(limb_t* r, limb_t const* a, limb_t const* b)
+    {
+        addmul_row<N - I>::run(r + I, a[I], b, 0);
+        mul_rows<I + 1, N>::run(r, a, b);
+    }
+};
+
+template<size_t N>
+struct mul_rows<N, N>
+{
+    static constexpr void run(limb_t*, limb_t const*, limb_t const*) {}
+};
+
+constexpr int count_leading_zeros(limb_t x)
+{
+    int n = 0;
+    for (limb_t bit = limb_t(1) << 63; bit != 0 && (x & bit) == 0; bit >>= 1)
+    {
+        n++;
+    }
+    return n;
+}
+}
+
+template<size_t Bits, bool Signed = true>
+struct fixed_integer
+{
+    static_assert(Bits != 0 && Bits % 64 == 0, "fixed_integer width must be a positive multiple of 64");
+
+    using limb_t = fixed_integer_detail::limb_t;
+    static constexpr size_t limbs = Bits / 64;
+
+    constexpr fixed_integer() : data_{} {}
+
+    template<typename I, typename = typename std::enable_if<std::is_integral<I>::value>::type>
+    constexpr fixed_integer(I a) : data_{}
+    {
+        data_[0] = static_cast<limb_t>(a);
+        if (a < I(0))
+        {
+            for (size_t i = 1; i != limbs; i++)
+            {
+                data_[i] = ~limb_t(0);
+            }
+        }
+    }
+
+    explicit fixed_integer(std::string const& str) : data_{}
+    {
+        if (!parse(str.data(), str.size()))
+        {
+            throw std::runtime_error("invalid string");
+        }
+    }
+
+    // truncates modulo 2^Bits
+    explicit fixed_integer(big_integer const& a) : data_{}
+    {
+        size_t n = mpz_size(a.mpz);
+        for (size_t i = 0; i != n && i != limbs; i++)
+        {
+            data_[i] = mpz_getlimbn(a.mpz, i);
+        }
+        if (mpz_sgn(a.mpz) < 0)
+        {
+            negate();
+        }
+    }
+
+    explicit operator big_integer() const
+    {
+        fixed_integer magnitude = is_negative() ? -*this : *this;
+        size_t n = magnitude.significant_limbs();
+        big_integer r;
+        mp_limb_t* out = mpz_limbs_write(r.mpz, n == 0 ? 1 : n);
+        for (size_t i = 0; i != n; i++)
+        {
+            out[i] = magnitude.data_[i];
+        }
+        mpz_limbs_finish(r.mpz, is_negative() ? -static_cast<mp_size_t>(n) : static_cast<mp_size_t>(n));
+        return r;
+    }
+
+    constexpr limb_t limb(size_t i) const
+    {
+        return data_[i];
+    }
+
+    constexpr fixed_integer& operator+=(fixed_integer const& rhs)
+    {
+        fixed_integer_detail::add_n<limbs>::run(data_, rhs.data_, 0);
+        return *this;
+    }
+
+    constexpr fixed_integer& operator-=(fixed_integer const& rhs)
+    {
+        fixed_integer_detail::sub_n<limbs>::run(data_, rhs.data_, 0);
+        return *this;
+    }
+
+    constexpr fixed_integer& operator*=(fixed_integer const& rhs)
+    {
+        fixed_integer r;
+        fixed_integer_detail::mul_rows<0, limbs>::run(r.data_, data_, rhs.data_);
+        return *this = r;
+    }
+
+    constexpr fixed_integer& operator/=(fixed_integer const& rhs)
+    {
+        fixed_integer r;
+        divmod(*this, rhs, *this, r);
+        return *this;
+    }
+
+    constexpr fixed_integer& operator%=(fixed_integer const& rhs)
+    {
+        fixed_integer q;
+        divmod(*this, rhs, q, *this);
+        return *this;
+    }
+
+    constexpr fixed_integer& operator&=(fixed_integer const& rhs)
+    {
+        for (size_t i = 0; i != limbs; i++)
+        {
+            data_[i] &= rhs.data_[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_integer& operator|=(fixed_integer const& rhs)
+    {
+        for (size_t i = 0; i != limbs; i++)
+        {
+            data_[i] |= rhs.data_[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_integer& operator^=(fixed_integer const& rhs)
+    {
+        for (size_t i = 0; i != limbs; i++)
+        {
+            data_[i] ^= rhs.data_[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_integer& operator<<=(uint64_t rhs)
+    {
+        uint64_t words = rhs / 64;
+        unsigned bits = static_cast<unsigned>(rhs % 64);
+        for (size_t i = limbs; i != 0; i--)
+        {
+            size_t to = i - 1;
+            limb_t cur = to >= words ? data_[to - words] << bits : 0;
+            if (bits != 0 && to > words)
+            {
+                cur |= data_[to - words - 1] >> (64 - bits);
+            }
+            data_[to] = cur;
+        }
+        return *this;
+    }
+
+    // arithmetic for signed values, i.e. rounds towards negative infinity
+    constexpr fixed_integer& operator>>=(uint64_t rhs)
+    {
+        limb_t fill = is_negative() ? ~limb_t(0) : 0;
+        uint64_t words = rhs / 64;
+        unsigned bits = static_cast<unsigned>(rhs % 64);
+        for (size_t to = 0; to != limbs; to++)
+        {
+            size_t from = to + words;
+            limb_t lo = from < limbs ? data_[from] : fill;
+            limb_t hi = from + 1 < limbs ? data_[from + 1] : fill;
+            data_[to] = bits == 0 ? lo : (lo >> bits) | (hi << (64 - bits));
+        }
+        return *this;
+    }
+
+    constexpr fixed_integer operator+() const
+    {
+        return *this;
+    }
+
+    constexpr fixed_integer operator-() const
+    {
+        fixed_integer r = *this;
+        r.negate();
+        return r;
+    }
+
+    constexpr fixed_integer operator~() const
+    {
+        fixed_integer r;
+        for (size_t i = 0; i != limbs; i++)
+        {
+            r.data_[i] = ~data_[i];
+        }
+        return r;
+    }
+
+    constexpr fixed_integer& operator++()
+    {
+        return *this += fixed_integer(1);
+    }
+
+    constexpr fixed_integer operator++(int)
+    {
+        fixed_integer r = *this;
+        ++*this;
+        return r;
+    }
+
+    constexpr fixed_integer& operator--()
+    {
+        return *this -= fixed_integer(1);
+    }
+
+    constexpr fixed_integer operator--(int)
+    {
+        fixed_integer r = *this;
+        --*this;
+        return r;
+    }
+
+    friend constexpr fixed_integer operator+(fixed_integer a, fixed_integer const& b)
+    {
+        return a += b;
+    }
+
+    friend constexpr fixed_integer operator-(fixed_integer a, fixed_integer const& b)
+    {
+        return a -= b;
+    }
+
+    friend constexpr fixed_integer operator*(fixed_integer a, fixed_integer const& b)
+    {
+        return a *= b;
+    }
+
+    friend constexpr fixed_integer operator/(fixed_integer a, fixed_integer const& b)
+    {
+        return a /= b;
+    }
+
+    friend constexpr fixed_integer operator%(fixed_integer a, fixed_integer const& b)
+    {
+        return a %= b;
+    }
+
+    friend constexpr fixed_integer operator&(fixed_integer a, fixed_integer const& b)
+    {
+        return a &= b;
+    }
+
+    friend constexpr fixed_integer operator|(fixed_integer a, fixed_integer const& b)
+    {
+        return a |= b;
+    }
+
+    friend constexpr fixed_integer operator^(fixed_integer a, fixed_integer const& b)
+    {
+        return a ^= b;
+    }
+
+    friend constexpr fixed_integer operator<<(fixed_integer a, uint64_t b)
+    {
+        return a <<= b;
+    }
+
+    friend constexpr fixed_integer operator>>(fixed_integer a, uint64_t b)
+    {
+        return a >>= b;
+    }
+
+    friend constexpr bool operator==(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) == 0;
+    }
+
+    friend constexpr bool operator!=(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) != 0;
+    }
+
+    friend constexpr bool operator<(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) < 0;
+    }
+
+    friend constexpr bool operator>(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) > 0;
+    }
+
+    friend constexpr bool operator<=(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) <= 0;
+    }
+
+    friend constexpr bool operator>=(fixed_integer const& a, fixed_integer const& b)
+    {
+        return compare(a, b) >= 0;
+    }
+
+    friend std::string to_string(fixed_integer const& a)
+    {
+        fixed_integer magnitude = a.is_negative() ? -a : a;
+        std::string res;
+        do
+        {
+            limb_t chunk = magnitude.divmod_1(10000000000000000000ull);
+            bool last = magnitude.significant_limbs() == 0;
+            for (int i = 0; i != 19 && (!last || chunk != 0); i++)
+            {
+                res.push_back(static_cast<char>('0' + chunk % 10));
+                chunk /= 10;
+            }
+        } while (magnitude.significant_limbs() != 0);
+        if (res.empty())
+        {
+            res.push_back('0');
+        }
+        if (a.is_negative())
+        {
+            res.push_back('-');
+        }
+        return std::string(res.rbegin(), res.rend());
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, fixed_integer const& a)
+    {
+        return s << to_string(a);
+    }
+
+private:
+    constexpr bool is_negative() const
+    {
+        return Signed && (data_[limbs - 1] >> 63) != 0;
+    }
+
+    constexpr size_t significant_limbs() const
+    {
+        size_t n = limbs;
+        while (n != 0 && data_[n - 1] == 0)
+        {
+            n--;
+        }
+        return n;
+    }
+
+    constexpr void negate()
+    {
+        limb_t carry = 1;
+        for (size_t i = 0; i != limbs; i++)
+        {
+            data_[i] = ~data_[i] + carry;
+            carry = carry && data_[i] == 0;
+        }
+    }
+
+    // *this = *this * m + a, returns the carry out of the top limb
+    constexpr limb_t muladd_1(limb_t m, limb_t a)
+    {
+        for (size_t i = 0; i != limbs; i++)
+        {
+            fixed_integer_detail::dlimb_t p = static_cast<fixed_integer_detail::dlimb_t>(data_[i]) * m + a;
+            data_[i] = static_cast<limb_t>(p);
+            a = static_cast<limb_t>(p >> 64);
+        }
+        return a;
+    }
+
+    // *this /= d as unsigned, returns the remainder
+    constexpr limb_t divmod_1(limb_t d)
+    {
+        fixed_integer_detail::dlimb_t rem = 0;
+        for (size_t i = limbs; i != 0; i--)
+        {
+            fixed_integer_detail::dlimb_t cur = (rem << 64) | data_[i - 1];
+            data_[i - 1] = static_cast<limb_t>(cur / d);
+            rem = cur % d;
+        }
+        return static_cast<limb_t>(rem);
+    }
+
+    // decimal with an optional leading '-', fails on empty input or any other character
+    constexpr bool parse(char const* str, size_t len)
+    {
+        bool negative = len != 0 && str[0] == '-';
+        size_t i = negative ? 1 : 0;
+        if (i == len)
+        {
+            return false;
+        }
+        for (; i != len; i++)
+        {
+            if (str[i] < '0' || str[i] > '9')
+            {
+                return false;
+            }
+            muladd_1(10, static_cast<limb_t>(str[i] - '0'));
+        }
+        if (negative)
+        {
+            negate();
+        }
+        return true;
+    }
+
+    // integer literal spelling: decimal, 0x hex, 0b binary or leading-zero octal, ' separators allowed
+    constexpr void parse_literal(char const* str, size_t len)
+    {
+        limb_t base = 10;
+        size_t i = 0;
+        if (len > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        {
+            base = 16;
+            i = 2;
+        }
+        else if (len > 2 && str[0] == '0' && (str[1] == 'b' || str[1] == 'B'))
+        {
+            base = 2;
+            i = 2;
+        }
+        else if (len > 1 && str[0] == '0')
+        {
+            base = 8;
+            i = 1;
+        }
+        for (; i != len; i++)
+        {
+            char c = str[i];
+            limb_t digit = base;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<limb_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                digit = static_cast<limb_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                digit = static_cast<limb_t>(c - 'A' + 10);
+            }
+            else if (c == '\'')
+            {
+                continue;
+            }
+            if (digit >= base)
+            {
+                throw std::invalid_argument("invalid digit in _bi literal");
+            }
+            muladd_1(base, digit);
+        }
+    }
+
+    static constexpr int compare(fixed_integer const& a, fixed_integer const& b)
+    {
+        if (a.is_negative() != b.is_negative())
+        {
+            return a.is_negative() ? -1 : 1;
+        }
+        return compare_unsigned(a, b);
+    }
+
+    static constexpr int compare_unsigned(fixed_integer const& a, fixed_integer const& b)
+    {
+        for (size_t i = limbs; i != 0; i--)
+        {
+            if (a.data_[i - 1] != b.data_[i - 1])
+            {
+                return a.data_[i - 1] < b.data_[i - 1] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // truncating division, the remainder takes the sign of the dividend
+    static constexpr void divmod(fixed_integer const& a, fixed_integer const& b, fixed_integer& q, fixed_integer& r)
+    {
+        bool negative_q = a.is_negative() != b.is_negative();
+        bool negative_r = a.is_negative();
+        divmod_unsigned(a.is_negative() ? -a : a, b.is_negative() ? -b : b, q, r);
+        if (negative_q)
+        {
+            q.negate();
+        }
+        if (negative_r)
+        {
+            r.negate();
+        }
+    }
+
+    // Knuth's algorithm D (TAOCP 4.3.1) on 64-bit limbs
+    static constexpr void divmod_unsigned(fixed_integer const& a, fixed_integer const& b, fixed_integer& q, fixed_integer& r)
+    {
+        using fixed_integer_detail::dlimb_t;
+        size_t n = b.significant_limbs();
+        size_t m = a.significant_limbs();
+        if (n == 0)
+        {
+            throw std::runtime_error("division by zero");
+        }
+        q = fixed_integer();
+        if (m < n || (m == n && compare_unsigned(a, b) < 0))
+        {
+            r = a;
+            return;
+        }
+        if (n == 1)
+        {
+            q = a;
+            r = fixed_integer(q.divmod_1(b.data_[0]));
+            return;
+        }
+
+        int shift = fixed_integer_detail::count_leading_zeros(b.data_[n - 1]);
+        limb_t un[limbs + 1] = {};
+        limb_t vn[limbs] = {};
+        for (size_t i = n; i != 0; i--)
+        {
+            vn[i - 1] = b.data_[i - 1] << shift;
+            if (shift != 0 && i > 1)
+            {
+                vn[i - 1] |= b.data_[i - 2] >> (64 - shift);
+            }
+        }
+        un[m] = shift == 0 ? 0 : a.data_[m - 1] >> (64 - shift);
+        for (size_t i = m; i != 0; i--)
+        {
+            un[i - 1] = a.data_[i - 1] << shift;
+            if (shift != 0 && i > 1)
+            {
+                un[i - 1] |= a.data_[i - 2] >> (64 - shift);
+            }
+        }
+
+        for (size_t j = m - n + 1; j != 0; j--)
+        {
+            size_t k = j - 1;
+            dlimb_t num = (static_cast<dlimb_t>(un[k + n]) << 64) | un[k + n - 1];
+            dlimb_t qhat = num / vn[n - 1];
+            dlimb_t rhat = num % vn[n - 1];
+            while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[k + n - 2]))
+            {
+                qhat--;
+                rhat += vn[n - 1];
+                if ((rhat >> 64) != 0)
+                {
+                    break;
+                }
+            }
+
+            limb_t borrow = 0;
+            limb_t carry = 0;
+            for (size_t i = 0; i != n; i++)
+            {
+                dlimb_t p = qhat * vn[i] + carry;
+                carry = static_cast<limb_t>(p >> 64);
+                dlimb_t t = static_cast<dlimb_t>(un[i + k]) - static_cast<limb_t>(p) - borrow;
+                un[i + k] = static_cast<limb_t>(t);
+                borrow = static_cast<limb_t>(t >> 127);
+            }
+            dlimb_t t = static_cast<dlimb_t>(un[k + n]) - carry - borrow;
+            un[k + n] = static_cast<limb_t>(t);
+
+            if ((t >> 127) != 0)
+            {
+                qhat--;
+                limb_t c = 0;
+                for (size_t i = 0; i != n; i++)
+                {
+                    dlimb_t s = static_cast<dlimb_t>(un[i + k]) + vn[i] + c;
+                    un[i + k] = static_cast<limb_t>(s);
+                    c = static_cast<limb_t>(s >> 64);
+                }
+                un[k + n] += c;
+            }
+            q.data_[k] = static_cast<limb_t>(qhat);
+        }
+
+        r = fixed_integer();
+        for (size_t i = 0; i != n; i++)
+        {
+            r.data_[i] = un[i] >> shift;
+            if (shift != 0)
+            {
+                r.data_[i] |= un[i + 1] << (64 - shift);
+            }
+        }
+    }
+
+    template<char... Chars>
+    friend struct fixed_integer_detail::literal;
+
+    limb_t data_[limbs];
+};
+
+namespace fixed_integer_detail
+{
+// enough whole limbs for the magnitude of the literal plus a sign bit
+constexpr size_t literal_bits(char const* str, size_t len)
+{
+    size_t bits_per_digit_x1000 = 3322;
+    size_t i = 0;
+    if (len > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+    {
+        bits_per_digit_x1000 = 4000;
+        i = 2;
+    }
+    else if (len > 2 && str[0] == '0' && (str[1] == 'b' || str[1] == 'B'))
+    {
+        bits_per_digit_x1000 = 1000;
+        i = 2;
+    }
+    else if (len > 1 && str[0] == '0')
+    {
+        bits_per_digit_x1000 = 3000;
+    }
+    size_t digits = 0;
+    for (; i != len; i++)
+    {
+        digits += str[i] != '\'';
+    }
+    size_t bits = (digits * bits_per_digit_x1000 + 999) / 1000 + 1;
+    return (bits + 63) / 64 * 64;
+}
+
+template<char... Chars>
+struct literal
+{
+    static constexpr char str[sizeof...(Chars)] = {Chars...};
+    using type = fixed_integer<literal_bits(str, sizeof...(Chars)), true>;
+
+    static constexpr type value()
+    {
+        type r;
+        r.parse_literal(str, sizeof...(Chars));
+        return r;
+    }
+};
+
+template<char... Chars>
+constexpr char literal<Chars...>::str[sizeof...(Chars)];
+}
+
+// 170141183460469231731687303715884105727_bi is parsed at compile time into a signed
+// fixed_integer just wide enough to hold it, convert explicitly to get a big_integer
+template<char... Chars>
+constexpr typename fixed_integer_detail::literal<Chars...>::type operator""_bi()
+{
+    return fixed_integer_detail::literal<Chars...>::value();
+}
+
+#endif // FIXED_INTEGER_H
@@ -0,0 +1,450 @@
+#include "limb_kernels.h"
+
+#include <cstdlib>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LIMB_KERNELS_X86_64
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(mp_limb_t) == sizeof(unsigned long long), "limb kernels expect 64-bit limbs");
+
+namespace
+{
+__extension__ typedef unsigned __int128 dlimb_t;
+
+enum class bit_op
+{
+    and_,
+    ior,
+    xor_
+};
+
+template<bit_op Op>
+mp_limb_t apply(mp_limb_t a, mp_limb_t b)
+{
+    return Op == bit_op::and_ ? a & b : Op == bit_op::ior ? a | b : a ^ b;
+}
+
+mp_limb_t add_n_portable(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    mp_limb_t carry = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        dlimb_t s = static_cast<dlimb_t>(a[i]) + b[i] + carry;
+        r[i] = static_cast<mp_limb_t>(s);
+        carry = static_cast<mp_limb_t>(s >> 64);
+    }
+    return carry;
+}
+
+mp_limb_t sub_n_portable(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    mp_limb_t borrow = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        dlimb_t d = static_cast<dlimb_t>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<mp_limb_t>(d);
+        borrow = static_cast<mp_limb_t>(d >> 127);
+    }
+    return borrow;
+}
+
+mp_limb_t mul_1_portable(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b)
+{
+    mp_limb_t carry = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        dlimb_t p = static_cast<dlimb_t>(a[i]) * b + carry;
+        r[i] = static_cast<mp_limb_t>(p);
+        carry = static_cast<mp_limb_t>(p >> 64);
+    }
+    return carry;
+}
+
+mp_limb_t addmul_1_portable(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b)
+{
+    mp_limb_t carry = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        dlimb_t p = static_cast<dlimb_t>(a[i]) * b + r[i] + carry;
+        r[i] = static_cast<mp_limb_t>(p);
+        carry = static_cast<mp_limb_t>(p >> 64);
+    }
+    return carry;
+}
+
+template<bit_op Op>
+void bitwise_portable(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    for (size_t i = 0; i != n; i++)
+    {
+        r[i] = apply<Op>(a[i], b[i]);
+    }
+}
+
+// high limbs first, so that r >= a is safe
+mp_limb_t lshift_portable(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[n - 1] >> (64 - shift);
+    for (size_t i = n - 1; i != 0; i--)
+    {
+        r[i] = (a[i] << shift) | (a[i - 1] >> (64 - shift));
+    }
+    r[0] = a[0] << shift;
+    return out;
+}
+
+// low limbs first, so that r <= a is safe
+mp_limb_t rshift_portable(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[0] << (64 - shift);
+    for (size_t i = 0; i != n - 1; i++)
+    {
+        r[i] = (a[i] >> shift) | (a[i + 1] << (64 - shift));
+    }
+    r[n - 1] = a[n - 1] >> shift;
+    return out;
+}
+
+#ifdef LIMB_KERNELS_X86_64
+__attribute__((target("adx")))
+mp_limb_t add_n_adx(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    unsigned char carry = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        unsigned long long s;
+        carry = _addcarryx_u64(carry, a[i], b[i], &s);
+        r[i] = s;
+    }
+    return carry;
+}
+
+__attribute__((target("adx")))
+mp_limb_t sub_n_adx(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    unsigned char borrow = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        unsigned long long d;
+        borrow = _subborrow_u64(borrow, a[i], b[i], &d);
+        r[i] = d;
+    }
+    return borrow;
+}
+
+__attribute__((target("bmi2,adx")))
+mp_limb_t mul_1_bmi2(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b)
+{
+    unsigned long long high = 0;
+    unsigned char carry = 0;
+    for (size_t i = 0; i != n; i++)
+    {
+        unsigned long long next_high;
+        unsigned long long low = _mulx_u64(a[i], b, &next_high);
+        unsigned long long s;
+        carry = _addcarryx_u64(carry, low, high, &s);
+        r[i] = s;
+        high = next_high;
+    }
+    return high + carry;
+}
+
+// Two independent carry chains: adcx (CF) adds the low product halves, adox (OF)
+// adds the high halves of the previous limb. Loop control uses lea/jrcxz only,
+// which leave both flags untouched.
+mp_limb_t addmul_1_adx(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b)
+{
+    mp_limb_t high;
+    mp_limb_t low;
+    mp_limb_t sum;
+    mp_limb_t next_high;
+    __asm__ volatile(
+        "xor %[high], %[high]\n\t"
+        "1:\n\t"
+        "mulx (%[a]), %[low], %[next_high]\n\t"
+        "mov (%[r]), %[sum]\n\t"
+        "adcx %[low], %[sum]\n\t"
+        "adox %[high], %[sum]\n\t"
+        "mov %[sum], (%[r])\n\t"
+        "mov %[next_high], %[high]\n\t"
+        "lea 8(%[a]), %[a]\n\t"
+        "lea 8(%[r]), %[r]\n\t"
+        "lea -1(%[n]), %[n]\n\t"
+        "jrcxz 2f\n\t"
+        "jmp 1b\n\t"
+        "2:\n\t"
+        "mov $0, %k[low]\n\t"
+        "adcx %[low], %[high]\n\t"
+        "adox %[low], %[high]\n\t"
+        : [high] "=&r"(high), [low] "=&r"(low), [sum] "=&r"(sum), [next_high] "=&r"(next_high),
+          [a] "+r"(a), [r] "+r"(r), [n] "+c"(n)
+        : "d"(b)
+        : "cc", "memory");
+    return high;
+}
+
+template<bit_op Op>
+__attribute__((target("avx2")))
+__m256i apply_avx2(__m256i a, __m256i b)
+{
+    return Op == bit_op::and_ ? _mm256_and_si256(a, b) : Op == bit_op::ior ? _mm256_or_si256(a, b) : _mm256_xor_si256(a, b);
+}
+
+template<bit_op Op>
+__attribute__((target("avx2")))
+void bitwise_avx2(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), apply_avx2<Op>(x, y));
+    }
+    for (; i != n; i++)
+    {
+        r[i] = apply<Op>(a[i], b[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+mp_limb_t lshift_avx2(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[n - 1] >> (64 - shift);
+    __m128i left = _mm_cvtsi32_si128(static_cast<int>(shift));
+    __m128i right = _mm_cvtsi32_si128(static_cast<int>(64 - shift));
+    size_t i = n;
+    for (; i >= 5; i -= 4)
+    {
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i - 4));
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i - 5));
+        __m256i res = _mm256_or_si256(_mm256_sll_epi64(high, left), _mm256_srl_epi64(low, right));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i - 4), res);
+    }
+    for (; i > 1; i--)
+    {
+        r[i - 1] = (a[i - 1] << shift) | (a[i - 2] >> (64 - shift));
+    }
+    r[0] = a[0] << shift;
+    return out;
+}
+
+__attribute__((target("avx2")))
+mp_limb_t rshift_avx2(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[0] << (64 - shift);
+    __m128i right = _mm_cvtsi32_si128(static_cast<int>(shift));
+    __m128i left = _mm_cvtsi32_si128(static_cast<int>(64 - shift));
+    size_t i = 0;
+    for (; i + 5 <= n; i += 4)
+    {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i + 1));
+        __m256i res = _mm256_or_si256(_mm256_srl_epi64(low, right), _mm256_sll_epi64(high, left));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), res);
+    }
+    for (; i + 1 < n; i++)
+    {
+        r[i] = (a[i] >> shift) | (a[i + 1] << (64 - shift));
+    }
+    r[n - 1] = a[n - 1] >> shift;
+    return out;
+}
+
+template<bit_op Op>
+__attribute__((target("avx512f")))
+__m512i apply_avx512(__m512i a, __m512i b)
+{
+    return Op == bit_op::and_ ? _mm512_and_si512(a, b) : Op == bit_op::ior ? _mm512_or_si512(a, b) : _mm512_xor_si512(a, b);
+}
+
+template<bit_op Op>
+__attribute__((target("avx512f")))
+void bitwise_avx512(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i y = _mm512_loadu_si512(b + i);
+        _mm512_storeu_si512(r + i, apply_avx512<Op>(x, y));
+    }
+    for (; i != n; i++)
+    {
+        r[i] = apply<Op>(a[i], b[i]);
+    }
+}
+
+__attribute__((target("avx512f")))
+mp_limb_t lshift_avx512(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[n - 1] >> (64 - shift);
+    __m128i left = _mm_cvtsi32_si128(static_cast<int>(shift));
+    __m128i right = _mm_cvtsi32_si128(static_cast<int>(64 - shift));
+    size_t i = n;
+    for (; i >= 9; i -= 8)
+    {
+        __m512i high = _mm512_loadu_si512(a + i - 8);
+        __m512i low = _mm512_loadu_si512(a + i - 9);
+        _mm512_storeu_si512(r + i - 8, _mm512_or_si512(_mm512_maskz_sll_epi64(0xFF, high, left), _mm512_maskz_srl_epi64(0xFF, low, right)));
+    }
+    for (; i > 1; i--)
+    {
+        r[i - 1] = (a[i - 1] << shift) | (a[i - 2] >> (64 - shift));
+    }
+    r[0] = a[0] << shift;
+    return out;
+}
+
+__attribute__((target("avx512f")))
+mp_limb_t rshift_avx512(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift)
+{
+    mp_limb_t out = a[0] << (64 - shift);
+    __m128i right = _mm_cvtsi32_si128(static_cast<int>(shift));
+    __m128i left = _mm_cvtsi32_si128(static_cast<int>(64 - shift));
+    size_t i = 0;
+    for (; i + 9 <= n; i += 8)
+    {
+        __m512i low = _mm512_loadu_si512(a + i);
+        __m512i high = _mm512_loadu_si512(a + i + 1);
+        _mm512_storeu_si512(r + i, _mm512_or_si512(_mm512_maskz_srl_epi64(0xFF, low, right), _mm512_maskz_sll_epi64(0xFF, high, left)));
+    }
+    for (; i + 1 < n; i++)
+    {
+        r[i] = (a[i] >> shift) | (a[i + 1] << (64 - shift));
+    }
+    r[n - 1] = a[n - 1] >> shift;
+    return out;
+}
+#endif
+
+bool cpu_supports(std::string const& name)
+{
+    if (name == "portable")
+    {
+        return true;
+    }
+#ifdef LIMB_KERNELS_X86_64
+    __builtin_cpu_init();
+    if (name == "bmi2_adx")
+    {
+        return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+    }
+    if (name == "avx2")
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+    if (name == "avx512")
+    {
+        return __builtin_cpu_supports("avx512f");
+    }
+#endif
+    return false;
+}
+
+void use_portable_arithmetic(limb_kernels& k)
+{
+    k.arithmetic = "portable";
+    k.add_n = add_n_portable;
+    k.sub_n = sub_n_portable;
+    k.mul_1 = mul_1_portable;
+    k.addmul_1 = addmul_1_portable;
+}
+
+void use_portable_bitwise(limb_kernels& k)
+{
+    k.bitwise = "portable";
+    k.and_n = bitwise_portable<bit_op::and_>;
+    k.ior_n = bitwise_portable<bit_op::ior>;
+    k.xor_n = bitwise_portable<bit_op::xor_>;
+    k.lshift = lshift_portable;
+    k.rshift = rshift_portable;
+}
+
+bool use(limb_kernels& k, std::string const& name)
+{
+    if (!cpu_supports(name))
+    {
+        return false;
+    }
+    if (name == "portable")
+    {
+        use_portable_arithmetic(k);
+        use_portable_bitwise(k);
+    }
+#ifdef LIMB_KERNELS_X86_64
+    else if (name == "bmi2_adx")
+    {
+        k.arithmetic = "bmi2_adx";
+        k.add_n = add_n_adx;
+        k.sub_n = sub_n_adx;
+        k.mul_1 = mul_1_bmi2;
+        k.addmul_1 = addmul_1_adx;
+    }
+    else if (name == "avx2")
+    {
+        k.bitwise = "avx2";
+        k.and_n = bitwise_avx2<bit_op::and_>;
+        k.ior_n = bitwise_avx2<bit_op::ior>;
+        k.xor_n = bitwise_avx2<bit_op::xor_>;
+        k.lshift = lshift_avx2;
+        k.rshift = rshift_avx2;
+    }
+    else if (name == "avx512")
+    {
+        k.bitwise = "avx512";
+        k.and_n = bitwise_avx512<bit_op::and_>;
+        k.ior_n = bitwise_avx512<bit_op::ior>;
+        k.xor_n = bitwise_avx512<bit_op::xor_>;
+        k.lshift = lshift_avx512;
+        k.rshift = rshift_avx512;
+    }
+#endif
+    return true;
+}
+
+char const* const variants[] = {"portable", "bmi2_adx", "avx2", "avx512"};
+
+limb_kernels& current()
+{
+    static limb_kernels k = [] {
+        limb_kernels best;
+        for (char const* name : variants)
+        {
+            use(best, name);
+        }
+        char const* forced = std::getenv("BIGINT_LIMB_KERNELS");
+        if (forced != nullptr)
+        {
+            use(best, forced);
+        }
+        return best;
+    }();
+    return k;
+}
+}
+
+limb_kernels const& active_limb_kernels()
+{
+    return current();
+}
+
+std::vector<std::string> supported_limb_kernels()
+{
+    std::vector<std::string> res;
+    for (char const* name : variants)
+    {
+        if (cpu_supports(name))
+        {
+            res.push_back(name);
+        }
+    }
+    return res;
+}
+
+bool force_limb_kernels(std::string const& name)
+{
+    return use(current(), name);
+}
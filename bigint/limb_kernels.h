@@ -0,0 +1,43 @@
+#ifndef LIMB_KERNELS_H
+#define LIMB_KERNELS_H
+
+#include <cstddef>
+#include <gmp.h>
+#include <string>
+#include <vector>
+
+// Inner loops over limb arrays that big_integer runs itself (GMP's own mpn layer
+// does its CPU dispatch internally). The fastest implementation the CPU supports
+// is picked on first use; BIGINT_LIMB_KERNELS=<name> in the environment or
+// force_limb_kernels(<name>) overrides the choice, e.g. to test every variant.
+//
+// Conventions follow mpn: n > 0, r may coincide with a source, lshift may also
+// write above its source and rshift below it; 0 < shift < 64.
+struct limb_kernels
+{
+    // carry-propagating arithmetic: "portable" or "bmi2_adx" (mulx/adcx/adox)
+    char const* arithmetic;
+    mp_limb_t (*add_n)(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n);
+    mp_limb_t (*sub_n)(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n);
+    mp_limb_t (*mul_1)(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b);
+    mp_limb_t (*addmul_1)(mp_limb_t* r, mp_limb_t const* a, size_t n, mp_limb_t b);
+
+    // limb-parallel bit operations: "portable", "avx2" or "avx512"
+    char const* bitwise;
+    void (*and_n)(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n);
+    void (*ior_n)(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n);
+    void (*xor_n)(mp_limb_t* r, mp_limb_t const* a, mp_limb_t const* b, size_t n);
+    mp_limb_t (*lshift)(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift);
+    mp_limb_t (*rshift)(mp_limb_t* r, mp_limb_t const* a, size_t n, unsigned shift);
+};
+
+limb_kernels const& active_limb_kernels();
+
+// names of the variants this CPU can run, "portable" first
+std::vector<std::string> supported_limb_kernels();
+
+// switches the family the variant belongs to ("portable" resets both); returns false
+// and changes nothing if the name is unknown or unsupported. Not thread-safe.
+bool force_limb_kernels(std::string const& name);
+
+#endif // LIMB_KERNELS_H
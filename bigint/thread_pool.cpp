@@ -0,0 +1,155 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+struct thread_pool::batch
+{
+    batch(std::function<void(size_t)> const& task, size_t count)
+        : task(task), count(count), next(0), finished(0)
+    {}
+
+    std::function<void(size_t)> const& task;
+    size_t const count;
+    std::atomic<size_t> next;
+    std::atomic<size_t> finished;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+thread_pool& thread_pool::instance()
+{
+    static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+thread_pool::thread_pool(size_t concurrency)
+    : concurrency_(std::max<size_t>(concurrency, 1)), stopping_(false)
+{}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    has_work_.notify_all();
+    for (std::thread& t : workers_)
+    {
+        t.join();
+    }
+}
+
+void thread_pool::set_concurrency(size_t concurrency)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    concurrency_ = std::max<size_t>(concurrency, 1);
+}
+
+size_t thread_pool::concurrency() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return concurrency_;
+}
+
+void thread_pool::parallel_for(size_t count, std::function<void(size_t)> const& task)
+{
+    size_t helpers = std::min(count, concurrency()) - (count == 0 ? 0 : 1);
+    if (helpers == 0)
+    {
+        for (size_t i = 0; i != count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::shared_ptr<batch> b = std::make_shared<batch>(task, count);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (workers_.size() < helpers)
+        {
+            workers_.emplace_back(&thread_pool::worker_loop, this);
+        }
+        for (size_t i = 0; i != helpers; i++)
+        {
+            queue_.push_back(b);
+        }
+    }
+    has_work_.notify_all();
+
+    work_on(*b);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (b->finished != count)
+        {
+            if (!run_one(lock))
+            {
+                batch_done_.wait(lock);
+            }
+        }
+    }
+    if (b->error)
+    {
+        std::rethrow_exception(b->error);
+    }
+}
+
+void thread_pool::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        has_work_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+        {
+            return;
+        }
+        run_one(lock);
+    }
+}
+
+// pops one queued batch and helps with it, the lock is released meanwhile
+bool thread_pool::run_one(std::unique_lock<std::mutex>& lock)
+{
+    if (queue_.empty())
+    {
+        return false;
+    }
+    std::shared_ptr<batch> b = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    work_on(*b);
+    lock.lock();
+    return true;
+}
+
+void thread_pool::work_on(batch& b)
+{
+    for (;;)
+    {
+        size_t i = b.next++;
+        if (i >= b.count)
+        {
+            return;
+        }
+        try
+        {
+            b.task(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(b.error_mutex);
+            if (!b.error)
+            {
+                b.error = std::current_exception();
+            }
+        }
+        if (++b.finished == b.count)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch_done_.notify_all();
+        }
+    }
+}
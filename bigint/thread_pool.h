@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Process-wide pool used by the parallel paths of big_integer. A thread that waits
+// for its batch keeps executing queued work, so batches may be nested freely
+// (e.g. recursive splitting) without deadlocking the pool.
+struct thread_pool
+{
+    static thread_pool& instance();
+
+    explicit thread_pool(size_t concurrency);
+    ~thread_pool();
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    // upper bound on threads working on one batch, including the caller
+    void set_concurrency(size_t concurrency);
+    size_t concurrency() const;
+
+    // calls task(0), ..., task(count - 1), possibly in parallel, and returns when all
+    // of them are finished; the first exception thrown by a task is rethrown
+    void parallel_for(size_t count, std::function<void(size_t)> const& task);
+
+private:
+    struct batch;
+
+    void worker_loop();
+    bool run_one(std::unique_lock<std::mutex>& lock);
+    void work_on(batch& b);
+
+    mutable std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::condition_variable batch_done_;
+    std::deque<std::shared_ptr<batch>> queue_;
+    std::vector<std::thread> workers_;
+    size_t concurrency_;
+    bool stopping_;
+};
+
+#endif // THREAD_POOL_H
@@ -1,16 +1,92 @@
 #include "vector.h"
+#include "memory_resource.h"
+#include "small_vector.h"
 #include "gtest/gtest.h"
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <unordered_set>
 
 template
 struct vector<int>;
 
+template
+struct small_vector<int, 4>;
+
+template<typename T, bool Propagate = false>
+struct tracking_allocator {
+  typedef T value_type;
+  typedef std::integral_constant<bool, Propagate> propagate_on_container_copy_assignment;
+  typedef std::integral_constant<bool, Propagate> propagate_on_container_move_assignment;
+  typedef std::integral_constant<bool, Propagate> propagate_on_container_swap;
+
+  explicit tracking_allocator(int id = 0) : id(id) {}
+
+  template<typename U>
+  tracking_allocator(tracking_allocator<U, Propagate> const& other) : id(other.id) {}
+
+  T* allocate(size_t n) {
+    ++live;
+    return static_cast<T*>(operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t) {
+    --live;
+    operator delete(p);
+  }
+
+  friend bool operator==(tracking_allocator const& a, tracking_allocator const& b) {
+    return a.id == b.id;
+  }
+
+  friend bool operator!=(tracking_allocator const& a, tracking_allocator const& b) {
+    return a.id != b.id;
+  }
+
+  int id;
+  // buffers allocated and not yet freed, by all instances
+  static size_t live;
+};
+
+template<typename T, bool Propagate>
+size_t tracking_allocator<T, Propagate>::live = 0;
+
+template
+struct vector<int, tracking_allocator<int> >;
+
+template
+struct vector<int, polymorphic_allocator<int> >;
+
+// counts what passes through to new_delete_resource()
+struct counting_resource : memory_resource {
+  size_t allocations = 0;
+  size_t deallocations = 0;
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    return new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    ++deallocations;
+    new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+};
+
 template<typename T>
 T const& as_const(T& obj) {
   return obj;
 }
 
-template<typename T>
+// NothrowMove picks whether the move operations are noexcept, and with them
+// whether a vector may move elements on reallocation
+template<typename T, bool NothrowMove = false>
 struct element {
   element() {
     add_instance();
@@ -25,6 +101,12 @@ struct element {
     add_instance();
   }
 
+  element(element&& rhs) noexcept(NothrowMove) : val(std::move(rhs.val)) {
+    rhs.assert_exists();
+    ++moves;
+    add_instance();
+  }
+
   element& operator=(element const& rhs) {
     assert_exists();
     rhs.assert_exists();
@@ -33,6 +115,14 @@ struct element {
     return *this;
   }
 
+  element& operator=(element&& rhs) noexcept(NothrowMove) {
+    assert_exists();
+    rhs.assert_exists();
+    ++moves;
+    val = std::move(rhs.val);
+    return *this;
+  }
+
   ~element() {
     delete_instance();
   }
@@ -53,6 +143,15 @@ struct element {
     throw_countdown = val;
   }
 
+  // copies and moves (construction and assignment) since the last reset
+  static size_t copies;
+  static size_t moves;
+
+  static void reset_counters() {
+    copies = 0;
+    moves = 0;
+  }
+
   friend bool operator==(element const& a, element const& b) {
     return a.val == b.val;
   }
@@ -89,6 +188,7 @@ private:
   }
 
   void copy() {
+    ++copies;
     if (throw_countdown != 0) {
       --throw_countdown;
       if (throw_countdown == 0)
@@ -101,8 +201,14 @@ private:
   static size_t throw_countdown;
 };
 
-template<typename T>
-size_t element<T>::throw_countdown = 0;
+template<typename T, bool NothrowMove>
+size_t element<T, NothrowMove>::throw_countdown = 0;
+
+template<typename T, bool NothrowMove>
+size_t element<T, NothrowMove>::copies = 0;
+
+template<typename T, bool NothrowMove>
+size_t element<T, NothrowMove>::moves = 0;
 
 TEST(correctness, default_ctor) {
   vector<element<int> > a;
@@ -138,6 +244,104 @@ TEST(correctness, push_back_from_self) {
   element<size_t>::expect_no_instances();
 }
 
+TEST(correctness, push_back_rvalue) {
+  typedef element<size_t, true> movable;
+  {
+    vector<movable> a;
+    a.reserve(2);
+    movable x(42);
+    movable::reset_counters();
+    a.push_back(std::move(x));
+    a.push_back(movable(43));
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(2, movable::moves);
+    EXPECT_EQ(42, a[0]);
+    EXPECT_EQ(43, a[1]);
+  }
+  movable::expect_no_instances();
+}
+
+TEST(correctness, emplace_back) {
+  typedef element<size_t, true> movable;
+  size_t const N = 500;
+  {
+    vector<movable> a;
+    movable::reset_counters();
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a.emplace_back(i));
+    EXPECT_EQ(0, movable::copies);
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a[i]);
+
+    // growth moves the old elements and never touches the new one
+    size_t size = a.size();
+    a.shrink_to_fit();
+    movable::reset_counters();
+    a.emplace_back(size);
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(size, movable::moves);
+  }
+  movable::expect_no_instances();
+
+  vector<int> b;
+  b.emplace_back();
+  EXPECT_EQ(0, b[0]);
+}
+
+TEST(correctness, emplace_back_from_self) {
+  size_t const N = 500;
+  {
+    vector<element<size_t> > a;
+    a.emplace_back(42);
+    for (size_t i = 0; i != N; ++i) a.emplace_back(a.back());
+
+    for (size_t i = 0; i != a.size(); ++i) EXPECT_EQ(42, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<size_t> b;
+  b.push_back(42);
+  for (size_t i = 0; i != N; ++i) b.emplace_back(b.back() + 1);
+  for (size_t i = 0; i != b.size(); ++i) EXPECT_EQ(42 + i, b[i]);
+}
+
+TEST(correctness, emplace) {
+  size_t const N = 500;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.emplace(a.begin() + a.size() / 2, i);
+    EXPECT_EQ(N, a.size());
+
+    // the middle element is inserted in front of itself, with and without growth
+    a.shrink_to_fit();
+    a.emplace(a.begin(), a[N / 2]);
+    a.emplace(a.begin(), a[N / 2 + 1]);
+    EXPECT_EQ(a[0], a[1]);
+    EXPECT_EQ(a[0], a[N / 2 + 2]);
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<size_t> b;
+  for (size_t i = 0; i != N; ++i) b.emplace(b.begin(), i);
+  for (size_t i = 0; i != N; ++i) EXPECT_EQ(N - 1 - i, b[i]);
+}
+
+TEST(correctness, move_only) {
+  size_t const N = 500;
+  vector<std::unique_ptr<size_t> > a;
+  for (size_t i = 0; i != N; ++i) {
+    if (i % 2 == 0) {
+      a.emplace_back(new size_t(i));
+    } else {
+      a.push_back(std::unique_ptr<size_t>(new size_t(i)));
+    }
+  }
+  a.emplace(a.begin(), new size_t(N));
+  a.insert(a.begin() + 1, std::unique_ptr<size_t>(new size_t(N + 1)));
+  EXPECT_EQ(N + 2, a.size());
+  EXPECT_EQ(N, *a[0]);
+  EXPECT_EQ(N + 1, *a[1]);
+  for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, *a[i + 2]);
+}
+
 TEST(correctness, subscription) {
   size_t const N = 500;
   vector<size_t> a;
@@ -322,6 +526,103 @@ TEST(correctness, insert_end) {
   element<size_t>::expect_no_instances();
 }
 
+TEST(correctness, insert_n) {
+  size_t const N = 100;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+
+    // growth, then a short and a long tail relative to the count within capacity
+    a.insert(a.begin() + 10, 3, a[0]);
+    a.reserve(1000);
+    a.insert(a.end() - 2, 5, 7);
+    a.insert(a.begin() + 1, 20, 8);
+    a.insert(a.end(), 0, 9);
+
+    vector<size_t> expected;
+    expected.push_back(0);
+    for (size_t i = 0; i != 20; ++i) expected.push_back(8);
+    for (size_t i = 1; i != 10; ++i) expected.push_back(i);
+    for (size_t i = 0; i != 3; ++i) expected.push_back(0);
+    for (size_t i = 10; i != N - 2; ++i) expected.push_back(i);
+    for (size_t i = 0; i != 5; ++i) expected.push_back(7);
+    expected.push_back(N - 2);
+    expected.push_back(N - 1);
+    ASSERT_EQ(expected.size(), a.size());
+    for (size_t i = 0; i != a.size(); ++i) EXPECT_EQ(expected[i], a[i]);
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<int> b;
+  b.insert(b.begin(), 3, 7);
+  b.insert(b.begin() + 1, 2, b[0] + 1);
+  int const expected[] = {7, 8, 8, 7, 7};
+  ASSERT_EQ(5, b.size());
+  for (size_t i = 0; i != 5; ++i) EXPECT_EQ(expected[i], b[i]);
+}
+
+TEST(correctness, insert_range) {
+  size_t const N = 100;
+  std::vector<size_t> source;
+  for (size_t i = 0; i != N; ++i) source.push_back(1000 + i);
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    a.reserve(1000);
+    element<size_t>::reset_counters();
+    a.insert(a.begin() + 50, source.begin(), source.begin() + 10);
+    // 10 elements constructed past the end, 40 shifted and 10 assigned, each once
+    EXPECT_EQ(0, element<size_t>::copies);
+    EXPECT_EQ(10 + 40 + 10, element<size_t>::moves);
+    a.insert(a.begin() + 10, source.begin(), source.end());
+    a.insert(a.begin(), {1, 2, 3});
+    a.insert(a.end(), source.end(), source.end());
+
+    ASSERT_EQ(3 + N + 10 + N, a.size());
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(i + 1, a[i]);
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[3 + i]);
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(1000 + i, a[13 + i]);
+    for (size_t i = 10; i != 50; ++i) EXPECT_EQ(i, a[3 + N + i]);
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(1000 + i, a[53 + N + i]);
+    for (size_t i = 50; i != N; ++i) EXPECT_EQ(i, a[13 + N + i]);
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<size_t> b;
+  b.insert(b.end(), source.begin(), source.end());
+  b.insert(b.begin() + 1, {7, 8});
+  ASSERT_EQ(N + 2, b.size());
+  EXPECT_EQ(1000, b[0]);
+  EXPECT_EQ(7, b[1]);
+  EXPECT_EQ(8, b[2]);
+  for (size_t i = 1; i != N; ++i) EXPECT_EQ(1000 + i, b[i + 2]);
+}
+
+TEST(correctness, insert_input_range) {
+  std::istringstream in("5 6 7");
+  vector<element<int> > a;
+  for (int i = 0; i != 4; ++i) a.push_back(i);
+  a.insert(a.begin() + 2, std::istream_iterator<int>(in), std::istream_iterator<int>());
+  int const expected[] = {0, 1, 5, 6, 7, 2, 3};
+  ASSERT_EQ(7, a.size());
+  for (size_t i = 0; i != 7; ++i) EXPECT_EQ(expected[i], a[i]);
+}
+
+TEST(correctness, insert_range_throw) {
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != 10; ++i) a.push_back(i);
+    a.shrink_to_fit();
+    vector<element<size_t> > b;
+    for (size_t i = 0; i != 10; ++i) b.push_back(100 + i);
+    element<size_t>::set_throw_countdown(5);
+    EXPECT_THROW(a.insert(a.begin() + 5, b.begin(), b.end()), std::runtime_error);
+    ASSERT_EQ(10, a.size());
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
 TEST(performance, insert)
 {
     const size_t N = 10000;
@@ -461,6 +762,65 @@ TEST(correctness, erase_big_range) {
   element<size_t>::expect_no_instances();
 }
 
+TEST(correctness, erase_moves) {
+  typedef element<size_t, true> movable;
+  size_t const N = 100;
+  {
+    vector<movable> a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    movable::reset_counters();
+    a.erase(a.begin() + 10, a.begin() + 20);
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(N - 20, movable::moves);
+    ASSERT_EQ(N - 10, a.size());
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[i]);
+    for (size_t i = 10; i != N - 10; ++i) EXPECT_EQ(i + 10, a[i]);
+  }
+  movable::expect_no_instances();
+
+  vector<int> b;
+  for (int i = 0; i != 10; ++i) b.push_back(i);
+  EXPECT_EQ(b.begin() + 2, b.erase(b.begin() + 2, b.begin() + 5));
+  int const expected[] = {0, 1, 5, 6, 7, 8, 9};
+  ASSERT_EQ(7, b.size());
+  for (size_t i = 0; i != 7; ++i) EXPECT_EQ(expected[i], b[i]);
+}
+
+TEST(correctness, erase_if) {
+  typedef element<size_t, true> movable;
+  size_t const N = 1000;
+  {
+    vector<movable> a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    movable::reset_counters();
+    size_t index = 0;
+    size_t erased = a.erase_if([&index](movable const&) { return index++ % 3 != 0; });
+    EXPECT_EQ(N - (N + 2) / 3, erased);
+    EXPECT_EQ(0, movable::copies);
+    ASSERT_EQ((N + 2) / 3, a.size());
+    for (size_t i = 0; i != a.size(); ++i) EXPECT_EQ(3 * i, a[i]);
+    size_t size = a.size();
+    EXPECT_EQ(size, a.erase_if([](movable const&) { return true; }));
+    EXPECT_TRUE(a.empty());
+  }
+  movable::expect_no_instances();
+}
+
+TEST(correctness, erase_unordered) {
+  size_t const N = 100;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    EXPECT_EQ(a.begin() + 10, a.erase_unordered(a.begin() + 10));
+    EXPECT_EQ(N - 1, a[10]);
+    EXPECT_EQ(a.end(), a.erase_unordered(a.end() - 1));
+    ASSERT_EQ(N - 2, a.size());
+    EXPECT_EQ(N - 3, a.back());
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
 TEST(correctness, reallocation_throw) {
   {
     vector<element<size_t> > a;
@@ -473,6 +833,54 @@ TEST(correctness, reallocation_throw) {
   element<size_t>::expect_no_instances();
 }
 
+TEST(correctness, reallocation_moves_if_noexcept) {
+  typedef element<size_t, true> movable;
+  size_t const N = 100;
+  {
+    vector<movable> a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    movable::reset_counters();
+    a.reserve(10 * N);
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(N, movable::moves);
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a[i]);
+
+    // a throwing move would lose the strong guarantee, so those elements are copied
+    vector<element<size_t>> b;
+    for (size_t i = 0; i != N; ++i) b.push_back(i);
+    element<size_t>::reset_counters();
+    b.reserve(10 * N);
+    EXPECT_EQ(N, element<size_t>::copies);
+    EXPECT_EQ(0, element<size_t>::moves);
+  }
+  movable::expect_no_instances();
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, trivially_copyable_growth) {
+  struct point {
+    int x, y;
+  };
+  size_t const N = 5000;
+  vector<point> a;
+  for (size_t i = 0; i != N; ++i) {
+    a.push_back(point{int(i), -int(i)});
+  }
+  a.shrink_to_fit();
+  EXPECT_EQ(N, a.capacity());
+  vector<point> b = a;
+  a.reserve(4 * N);
+  a.clear();
+  for (size_t i = 0; i != N; ++i) {
+    EXPECT_EQ(i, b[i].x);
+    EXPECT_EQ(-int(i), b[i].y);
+  }
+  b.shrink_to_fit();
+  EXPECT_EQ(N, b.capacity());
+  a.shrink_to_fit();
+  EXPECT_EQ(nullptr, a.data());
+}
+
 TEST(correctness, empty_storage) {
   vector<int> a;
   EXPECT_EQ(nullptr, a.data());
@@ -522,3 +930,427 @@ TEST(correctness, ctor_alloc) {
   EXPECT_EQ(1, b.capacity());
 }
 
+TEST(small_vector, inline_storage) {
+  {
+    small_vector<element<size_t>, 4> a;
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_EQ(4, a.capacity());
+    for (size_t i = 0; i != 4; ++i) a.push_back(i);
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_TRUE(static_cast<void*>(a.data()) >= static_cast<void*>(&a) &&
+                static_cast<void*>(a.data() + 4) <= static_cast<void*>(&a + 1));
+
+    a.push_back(a[0]);
+    EXPECT_FALSE(a.is_inline());
+    EXPECT_EQ(8, a.capacity());
+    for (size_t i = 0; i != 4; ++i) EXPECT_EQ(i, a[i]);
+    EXPECT_EQ(0, a[4]);
+
+    a.pop_back();
+    a.shrink_to_fit();
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_EQ(4, a.capacity());
+    for (size_t i = 0; i != 4; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(small_vector, copy) {
+  {
+    small_vector<element<size_t>, 4> a;
+    for (size_t i = 0; i != 3; ++i) a.push_back(i);
+    small_vector<element<size_t>, 4> b = a;
+    EXPECT_TRUE(b.is_inline());
+    for (size_t i = 3; i != 10; ++i) a.push_back(i);
+    small_vector<element<size_t>, 4> c = a;
+    EXPECT_FALSE(c.is_inline());
+    EXPECT_EQ(10, c.capacity());
+    b = c;
+    ASSERT_EQ(10, b.size());
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, b[i]);
+    c = small_vector<element<size_t>, 4>();
+    EXPECT_TRUE(c.empty());
+    EXPECT_TRUE(c.is_inline());
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(small_vector, move) {
+  typedef element<size_t, true> movable;
+  typedef small_vector<movable, 4> vec_t;
+  static_assert(std::is_nothrow_move_constructible<vec_t>::value, "moving inline elements cannot throw");
+  {
+    vec_t heap;
+    for (size_t i = 0; i != 10; ++i) heap.push_back(i);
+    movable const* heap_data = heap.data();
+    movable::reset_counters();
+
+    // the heap buffer changes hands, no element is touched
+    vec_t a(std::move(heap));
+    EXPECT_EQ(heap_data, a.data());
+    EXPECT_EQ(10, a.size());
+    EXPECT_TRUE(heap.empty());
+    EXPECT_TRUE(heap.is_inline());
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(0, movable::moves);
+
+    // inline elements are moved once each
+    vec_t in;
+    for (size_t i = 0; i != 3; ++i) in.push_back(i);
+    movable::reset_counters();
+    vec_t b(std::move(in));
+    EXPECT_TRUE(b.is_inline());
+    EXPECT_TRUE(in.empty());
+    EXPECT_EQ(0, movable::copies);
+    EXPECT_EQ(3, movable::moves);
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(i, b[i]);
+
+    // assignment: from the heap takes the buffer, from inline goes inline
+    movable::reset_counters();
+    b = std::move(a);
+    EXPECT_EQ(heap_data, b.data());
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0, movable::moves);
+    for (size_t i = 0; i != 3; ++i) a.push_back(i + 100);
+    movable::reset_counters();
+    b = std::move(a);
+    EXPECT_TRUE(b.is_inline());
+    EXPECT_EQ(3, movable::moves);
+    ASSERT_EQ(3, b.size());
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(i + 100, b[i]);
+    EXPECT_EQ(0, movable::copies);
+    b = std::move(b);
+    EXPECT_EQ(3, b.size());
+  }
+  movable::expect_no_instances();
+
+  // moves that may throw are copies, so other survives a failure
+  small_vector<element<size_t>, 4> c;
+  c.push_back(1);
+  element<size_t>::reset_counters();
+  small_vector<element<size_t>, 4> d(std::move(c));
+  EXPECT_EQ(1, element<size_t>::copies);
+  EXPECT_EQ(1, d[0]);
+}
+
+TEST(small_vector, swap) {
+  typedef small_vector<element<size_t>, 4> vec_t;
+  {
+    vec_t inline_a, inline_b, heap_a, heap_b;
+    for (size_t i = 0; i != 3; ++i) inline_a.push_back(i);
+    inline_b.push_back(100);
+    for (size_t i = 0; i != 6; ++i) heap_a.push_back(200 + i);
+    for (size_t i = 0; i != 7; ++i) heap_b.push_back(300 + i);
+    element<size_t> const* heap_a_data = heap_a.data();
+
+    inline_a.swap(inline_b);
+    ASSERT_EQ(1, inline_a.size());
+    ASSERT_EQ(3, inline_b.size());
+    EXPECT_EQ(100, inline_a[0]);
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(i, inline_b[i]);
+
+    heap_a.swap(inline_b);
+    EXPECT_TRUE(heap_a.is_inline());
+    EXPECT_EQ(heap_a_data, inline_b.data());
+    ASSERT_EQ(3, heap_a.size());
+    ASSERT_EQ(6, inline_b.size());
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(i, heap_a[i]);
+    for (size_t i = 0; i != 6; ++i) EXPECT_EQ(200 + i, inline_b[i]);
+
+    inline_b.swap(heap_b);
+    EXPECT_EQ(heap_a_data, heap_b.data());
+    EXPECT_EQ(300, inline_b[0]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(small_vector, insert_erase) {
+  {
+    small_vector<element<size_t>, 4> a;
+    a.insert(a.begin(), {1, 2});
+    a.insert(a.begin() + 1, 2, 7);
+    EXPECT_TRUE(a.is_inline());
+    a.emplace(a.begin(), 0);
+    EXPECT_FALSE(a.is_inline());
+    std::vector<size_t> more = {8, 9};
+    a.insert(a.end(), more.begin(), more.end());
+    a.insert(a.begin() + 2, a[0]);
+    size_t const expected[] = {0, 1, 0, 7, 7, 2, 8, 9};
+    ASSERT_EQ(8, a.size());
+    for (size_t i = 0; i != 8; ++i) EXPECT_EQ(expected[i], a[i]);
+
+    a.erase(a.begin() + 2, a.begin() + 5);
+    a.erase_unordered(a.begin());
+    EXPECT_EQ(1, a.erase_if([](element<size_t> const& x) { return x == element<size_t>(8); }));
+    size_t const left[] = {9, 1, 2};
+    ASSERT_EQ(3, a.size());
+    for (size_t i = 0; i != 3; ++i) EXPECT_EQ(left[i], a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(small_vector, spill_throw) {
+  {
+    small_vector<element<size_t>, 4> a;
+    for (size_t i = 0; i != 4; ++i) a.push_back(i);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(a.push_back(42), std::runtime_error);
+    EXPECT_TRUE(a.is_inline());
+    ASSERT_EQ(4, a.size());
+    for (size_t i = 0; i != 4; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(small_vector, trivial) {
+  small_vector<int, 8> a;
+  for (int i = 0; i != 100; ++i) a.push_back(i);
+  a.erase(a.begin() + 10, a.end());
+  a.shrink_to_fit();
+  EXPECT_FALSE(a.is_inline());
+  a.erase(a.begin() + 5, a.end());
+  a.shrink_to_fit();
+  EXPECT_TRUE(a.is_inline());
+  ASSERT_EQ(5, a.size());
+  for (int i = 0; i != 5; ++i) EXPECT_EQ(i, a[i]);
+}
+
+TEST(allocator, used_for_every_buffer) {
+  typedef tracking_allocator<element<size_t> > alloc_t;
+  // stateless allocators take no space
+  EXPECT_EQ(3 * sizeof(void*), sizeof(vector<int>));
+  {
+    vector<element<size_t>, alloc_t> a(alloc_t(1));
+    for (size_t i = 0; i != 1000; ++i) a.push_back(i);
+    a.insert(a.begin(), 100, 7);
+    a.shrink_to_fit();
+    EXPECT_EQ(1, alloc_t::live);
+
+    vector<element<size_t>, alloc_t> b = a;
+    EXPECT_EQ(1, b.get_allocator().id);
+    EXPECT_EQ(2, alloc_t::live);
+    for (size_t i = 0; i != 1000; ++i) EXPECT_EQ(i, b[100 + i]);
+  }
+  EXPECT_EQ(0, alloc_t::live);
+  element<size_t>::expect_no_instances();
+}
+
+TEST(allocator, propagation) {
+  typedef tracking_allocator<int, true> propagating;
+  typedef tracking_allocator<int, false> staying;
+  {
+    vector<int, propagating> a(propagating(1)), b(propagating(2));
+    a.push_back(1);
+    b = a;
+    EXPECT_EQ(1, b.get_allocator().id);
+    vector<int, propagating> c(propagating(3));
+    c.swap(b);
+    EXPECT_EQ(1, c.get_allocator().id);
+    EXPECT_EQ(3, b.get_allocator().id);
+    b = std::move(c);
+    EXPECT_EQ(1, b.get_allocator().id);
+    EXPECT_EQ(1, b[0]);
+
+    vector<int, staying> d(staying(1)), e(staying(2));
+    d.push_back(1);
+    e = d;
+    EXPECT_EQ(2, e.get_allocator().id);
+    EXPECT_EQ(1, e[0]);
+
+    // unequal allocators that stay: the elements move, the buffer does not
+    int const* data = d.data();
+    e = std::move(d);
+    EXPECT_EQ(2, e.get_allocator().id);
+    EXPECT_NE(data, e.data());
+    EXPECT_EQ(1, e[0]);
+    EXPECT_TRUE(d.empty());
+
+    vector<int, staying> f(staying(2));
+    data = e.data();
+    f = std::move(e);
+    EXPECT_EQ(data, f.data());
+    EXPECT_EQ(nullptr, e.data());
+  }
+  EXPECT_EQ(0, propagating::live);
+  EXPECT_EQ(0, staying::live);
+}
+
+TEST(allocator, move_ctor) {
+  vector<element<size_t> > a;
+  for (size_t i = 0; i != 10; ++i) a.push_back(i);
+  element<size_t> const* data = a.data();
+  vector<element<size_t> > b(std::move(a));
+  EXPECT_EQ(data, b.data());
+  EXPECT_EQ(nullptr, a.data());
+  EXPECT_EQ(10, b.size());
+}
+
+TEST(allocator, monotonic_arena) {
+  counting_resource upstream;
+  {
+    monotonic_buffer_resource arena(&upstream);
+    {
+      vector<size_t, polymorphic_allocator<size_t> > a(&arena);
+      vector<std::string, polymorphic_allocator<std::string> > b(&arena);
+      for (size_t i = 0; i != 10000; ++i) {
+        a.push_back(i);
+        b.push_back(std::to_string(i));
+      }
+      for (size_t i = 0; i != 10000; ++i) {
+        EXPECT_EQ(i, a[i]);
+        EXPECT_EQ(std::to_string(i), b[i]);
+      }
+      EXPECT_EQ(&arena, a.get_allocator().resource());
+
+      // a copy does not stay in the arena
+      vector<size_t, polymorphic_allocator<size_t> > c = a;
+      EXPECT_EQ(get_default_resource(), c.get_allocator().resource());
+    }
+    // a chunk per doubling of the arena, and nothing freed before it goes
+    EXPECT_GT(20, upstream.allocations);
+    EXPECT_EQ(0, upstream.deallocations);
+  }
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+
+  char buffer[256];
+  monotonic_buffer_resource small(buffer, sizeof(buffer), &upstream);
+  size_t before = upstream.allocations;
+  vector<int, polymorphic_allocator<int> > d(&small);
+  for (int i = 0; i != 8; ++i) d.push_back(i);
+  EXPECT_GE(d.data(), reinterpret_cast<int*>(buffer));
+  EXPECT_LT(d.data(), reinterpret_cast<int*>(buffer + sizeof(buffer)));
+  EXPECT_EQ(before, upstream.allocations);
+}
+
+// the capacities a vector goes through while growing to n elements
+template<typename Vector>
+std::vector<size_t> capacities(size_t n) {
+  std::vector<size_t> result;
+  Vector a;
+  for (size_t i = 0; i != n; ++i) {
+    a.push_back(i);
+    if (result.empty() || result.back() != a.capacity()) result.push_back(a.capacity());
+  }
+  return result;
+}
+
+TEST(growth, policies) {
+  typedef element<size_t> el_t;
+  typedef std::allocator<el_t> alloc_t;
+  typedef vector<el_t, alloc_t, growth_factor_1_5> by_1_5;
+  typedef vector<el_t, alloc_t, growth_golden> golden;
+  EXPECT_EQ(std::vector<size_t>({4, 8, 16, 32}), capacities<vector<el_t> >(20));
+  EXPECT_EQ(std::vector<size_t>({4, 6, 9, 13, 19, 28}), capacities<by_1_5>(20));
+  EXPECT_EQ(std::vector<size_t>({4, 6, 9, 14, 22}), capacities<golden>(20));
+
+  typedef growth_page_rounded<growth_factor_1_5, 1024, 4096> paged;
+  for (size_t c : capacities<vector<el_t, alloc_t, paged> >(5000)) {
+    if (c * sizeof(el_t) >= 1024) {
+      EXPECT_EQ(0, c * sizeof(el_t) % 4096);
+    }
+  }
+  el_t::expect_no_instances();
+}
+
+TEST(growth, malloc_slack) {
+  vector<int> a;
+  a.push_back(0);
+  EXPECT_LE(4, a.capacity());
+  int* data = a.data();
+  while (a.size() != a.capacity()) a.push_back(0);
+  EXPECT_EQ(data, a.data());
+
+  // slack is only taken on growth: shrink_to_fit and copies stay exact
+  a.push_back(1);
+  a.shrink_to_fit();
+  EXPECT_EQ(a.size(), a.capacity());
+  a.reserve(1000);
+  EXPECT_LE(1000, a.capacity());
+  vector<int> b = a;
+  EXPECT_EQ(b.size(), b.capacity());
+}
+
+TEST(growth, mapped_buffers) {
+  size_t const threshold = VECTOR_MMAP_THRESHOLD / sizeof(double);
+  vector<double> a;
+  for (size_t i = 0; i != threshold + threshold / 2; ++i) a.push_back(static_cast<double>(i));
+#ifdef VECTOR_MMAP
+  // a mapping starts on a page and fills its last one
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a.data()) % 4096);
+  EXPECT_EQ(0u, a.capacity() * sizeof(double) % 4096);
+#endif
+  a.reserve(4 * threshold);
+  EXPECT_LE(4 * threshold, a.capacity());
+  vector<double> b = a;
+  EXPECT_EQ(b.size(), b.capacity());
+
+  // back below the threshold, into malloc
+  a.erase(a.begin() + 1000, a.end());
+  a.shrink_to_fit();
+  EXPECT_EQ(1000u, a.capacity());
+  for (size_t i = 0; i != 1000; ++i) ASSERT_EQ(static_cast<double>(i), a[i]);
+  for (size_t i = 0; i < b.size(); i += 4099) ASSERT_EQ(static_cast<double>(i), b[i]);
+  EXPECT_EQ(static_cast<double>(b.size() - 1), b.back());
+}
+
+TEST(correctness, resize) {
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != 10; ++i) a.push_back(i);
+    a.resize(4);
+    EXPECT_EQ(4u, a.size());
+    a.resize(50, a[3]);
+    ASSERT_EQ(50u, a.size());
+    for (size_t i = 0; i != 4; ++i) EXPECT_EQ(i, a[i]);
+    for (size_t i = 4; i != 50; ++i) EXPECT_EQ(3u, a[i]);
+    a.resize(60);
+    EXPECT_EQ(60u, a.size());
+    a.resize(0);
+    EXPECT_TRUE(a.empty());
+  }
+  element<size_t>::expect_no_instances();
+
+  // value-initialized, even where earlier elements were
+  vector<int> b;
+  for (int i = 0; i != 10; ++i) b.push_back(i + 1);
+  b.resize(2);
+  b.resize(1000);
+  for (size_t i = 2; i != b.size(); ++i) ASSERT_EQ(0, b[i]);
+
+  // amortized like push_back
+  vector<int> c;
+  for (size_t i = 1; i != 1000; ++i) c.resize(i);
+  EXPECT_LE(999u, c.capacity());
+  EXPECT_GE(2000u, c.capacity());
+}
+
+TEST(correctness, resize_throw) {
+  vector<element<size_t> > a;
+  for (size_t i = 0; i != 10; ++i) a.push_back(i);
+  element<size_t>::set_throw_countdown(5);
+  EXPECT_THROW(a.resize(100, 7), std::runtime_error);
+  ASSERT_EQ(10u, a.size());
+  for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[i]);
+}
+
+TEST(correctness, resize_for_overwrite) {
+  {
+    vector<element<size_t> > a;
+    a.push_back(1);
+    a.reserve(20);
+    element<size_t>::reset_counters();
+    a.resize_for_overwrite(20);
+    EXPECT_EQ(20u, a.size());
+    EXPECT_EQ(0u, element<size_t>::copies);
+    a.resize_for_overwrite(1);
+    EXPECT_EQ(1u, a[0]);
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<char> b;
+  b.resize_for_overwrite(4096);
+  ASSERT_EQ(4096u, b.size());
+  std::memset(b.data(), 'x', b.size());
+  b.resize_for_overwrite(8192);
+  EXPECT_EQ('x', b[4095]);
+}
@@ -0,0 +1,229 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// A C++11 rendition of the std::pmr interface: memory_resource, polymorphic_allocator
+// and a monotonic arena, so that vector<T, polymorphic_allocator<T>> can draw its
+// buffers from a resource chosen at run time.
+struct memory_resource {
+    static size_t const max_align = alignof(std::max_align_t);
+
+    virtual ~memory_resource() = default;
+
+    void *allocate(size_t bytes, size_t alignment = max_align) {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void *p, size_t bytes, size_t alignment = max_align) {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(memory_resource const &other) const noexcept {
+        return do_is_equal(other);
+    }
+
+private:
+    virtual void *do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void *p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(memory_resource const &other) const noexcept = 0;
+};
+
+inline bool operator==(memory_resource const &a, memory_resource const &b) noexcept {
+    return &a == &b || a.is_equal(b);
+}
+
+inline bool operator!=(memory_resource const &a, memory_resource const &b) noexcept {
+    return !(a == b);
+}
+
+namespace memory_resource_detail {
+struct new_delete : memory_resource {
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        assert(alignment <= max_align);
+        (void) alignment;
+        return operator new(bytes);
+    }
+
+    void do_deallocate(void *p, size_t, size_t) override {
+        operator delete(p);
+    }
+
+    bool do_is_equal(memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+};
+}
+
+// global operator new and delete, alignments up to max_align
+inline memory_resource *new_delete_resource() noexcept {
+    static memory_resource_detail::new_delete resource;
+    return &resource;
+}
+
+namespace memory_resource_detail {
+inline std::atomic<memory_resource *> &default_resource() {
+    static std::atomic<memory_resource *> resource{new_delete_resource()};
+    return resource;
+}
+}
+
+// what default-constructed polymorphic_allocators use, new_delete_resource() unless set
+inline memory_resource *get_default_resource() noexcept {
+    return memory_resource_detail::default_resource().load();
+}
+
+// nullptr restores new_delete_resource(), returns the previous default
+inline memory_resource *set_default_resource(memory_resource *r) noexcept {
+    return memory_resource_detail::default_resource().exchange(r != nullptr ? r : new_delete_resource());
+}
+
+// Copies share the resource. Containers never propagate it on assignment or swap,
+// and a copied container goes back to the default resource.
+template<typename T>
+struct polymorphic_allocator {
+    typedef T value_type;
+
+    polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+    polymorphic_allocator(memory_resource *resource) noexcept : resource_(resource) {}
+
+    template<typename U>
+    polymorphic_allocator(polymorphic_allocator<U> const &other) noexcept : resource_(other.resource()) {}
+
+    polymorphic_allocator &operator=(polymorphic_allocator const &) = delete;
+
+    T *allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const {
+        return polymorphic_allocator();
+    }
+
+    memory_resource *resource() const noexcept {
+        return resource_;
+    }
+
+private:
+    memory_resource *resource_;
+};
+
+template<typename T, typename U>
+bool operator==(polymorphic_allocator<T> const &a, polymorphic_allocator<U> const &b) noexcept {
+    return *a.resource() == *b.resource();
+}
+
+template<typename T, typename U>
+bool operator!=(polymorphic_allocator<T> const &a, polymorphic_allocator<U> const &b) noexcept {
+    return !(a == b);
+}
+
+// An arena: allocation bumps a pointer through chunks obtained from the upstream
+// resource, each twice the size of the last, and deallocate does nothing. Everything
+// is given back at once by release() or the destructor, so containers that live
+// for one request need no frees of their own. Not thread safe.
+struct monotonic_buffer_resource : memory_resource {
+    explicit monotonic_buffer_resource(memory_resource *upstream = get_default_resource()) :
+            monotonic_buffer_resource(initial_chunk, upstream) {}
+
+    explicit monotonic_buffer_resource(size_t initial_size, memory_resource *upstream = get_default_resource()) :
+            upstream_(upstream),
+            chunks_(nullptr),
+            current_(nullptr),
+            left_(0),
+            next_size_(std::max<size_t>(initial_size, 1)) {}
+
+    // the first allocations are served from buffer, which is not freed
+    monotonic_buffer_resource(void *buffer, size_t size, memory_resource *upstream = get_default_resource()) :
+            upstream_(upstream),
+            chunks_(nullptr),
+            current_(static_cast<char *>(buffer)),
+            left_(size),
+            next_size_(std::max(2 * size, size_t(initial_chunk))) {}
+
+    monotonic_buffer_resource(monotonic_buffer_resource const &) = delete;
+    monotonic_buffer_resource &operator=(monotonic_buffer_resource const &) = delete;
+
+    ~monotonic_buffer_resource() override {
+        release();
+    }
+
+    // frees every chunk, the initial buffer (if any) is not reused
+    void release() {
+        while (chunks_ != nullptr) {
+            chunk *next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->size, alignof(chunk));
+            chunks_ = next;
+        }
+        current_ = nullptr;
+        left_ = 0;
+    }
+
+    memory_resource *upstream_resource() const {
+        return upstream_;
+    }
+
+private:
+    static size_t const initial_chunk = 1024;
+
+    struct chunk {
+        chunk *next;
+        size_t size;
+    };
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        void *p = take(bytes, alignment);
+        if (p == nullptr) {
+            size_t size = std::max(next_size_, sizeof(chunk) + bytes + alignment);
+            chunk *c = static_cast<chunk *>(upstream_->allocate(size, alignof(chunk)));
+            c->next = chunks_;
+            c->size = size;
+            chunks_ = c;
+            current_ = reinterpret_cast<char *>(c + 1);
+            left_ = size - sizeof(chunk);
+            next_size_ = 2 * size;
+            p = take(bytes, alignment);
+        }
+        return p;
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+
+    // nullptr if the current chunk is too small
+    void *take(size_t bytes, size_t alignment) {
+        size_t pad = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+        if (current_ == nullptr || left_ < pad || left_ - pad < bytes) {
+            return nullptr;
+        }
+        void *p = current_ + pad;
+        current_ += pad + bytes;
+        left_ -= pad + bytes;
+        return p;
+    }
+
+    memory_resource *upstream_;
+    chunk *chunks_;
+    char *current_;
+    size_t left_;
+    size_t next_size_;
+};
+
+#endif // MEMORY_RESOURCE_H
@@ -0,0 +1,546 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "vector.h"
+
+// A vector that keeps up to N elements inside the object and goes to the heap only
+// once it outgrows them (and back on shrink_to_fit). Interface and guarantees are
+// those of vector, except swap: inline elements have to be moved, so it is O(N) and
+// only basic unless both sides are on the heap or moving T cannot throw.
+template<typename T, size_t N>
+struct small_vector {
+    static_assert(N != 0, "small_vector needs inline capacity, use vector");
+
+    using iterator = T *;
+    using const_iterator = T const *;
+
+    small_vector();                                     // O(1) nothrow
+    small_vector(small_vector const &);                 // O(N) strong
+    small_vector(small_vector &&) noexcept(std::is_nothrow_move_constructible<T>::value); // O(N) strong, O(1) on the heap
+    small_vector &operator=(small_vector const &other); // O(N) strong, see swap
+    small_vector &operator=(small_vector &&other);      // O(N) basic, O(1) nothrow on the heap
+
+    ~small_vector();                                    // O(N) nothrow
+
+    T &operator[](size_t i);                // O(1) nothrow
+    T const &operator[](size_t i) const;    // O(1) nothrow
+
+    iterator data();                        // O(1) nothrow
+    const_iterator data() const;            // O(1) nothrow
+    size_t size() const;                    // O(1) nothrow
+
+    T &front();                             // O(1) nothrow
+    T const &front() const;                 // O(1) nothrow
+
+    T &back();                              // O(1) nothrow
+    T const &back() const;                  // O(1) nothrow
+    void push_back(T const &);              // O(1)* strong
+    void push_back(T &&);                   // O(1)* strong
+    template<typename... Args>
+    T &emplace_back(Args &&... args);       // O(1)* strong
+    void pop_back();                        // O(1) nothrow
+
+    bool empty() const;                     // O(1) nothrow
+    bool is_inline() const;                 // O(1) nothrow
+
+    size_t capacity() const;                // O(1) nothrow
+    void reserve(size_t);                   // O(N) strong
+    void shrink_to_fit();                   // O(N) strong
+
+    void clear();                           // O(N) nothrow
+
+    void swap(small_vector &);              // O(N) basic, O(1) nothrow on the heap
+
+    iterator begin();                       // O(1) nothrow
+    iterator end();                         // O(1) nothrow
+
+    const_iterator begin() const;           // O(1) nothrow
+    const_iterator end() const;             // O(1) nothrow
+
+    iterator insert(const_iterator pos, T const &); // O(N) weak
+    iterator insert(const_iterator pos, T &&);      // O(N) weak
+    iterator insert(const_iterator pos, size_t n, T const &); // O(N + n) weak
+    template<typename InputIt,
+            typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last); // O(N + k) weak
+    iterator insert(const_iterator pos, std::initializer_list<T>);     // O(N + k) weak
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args &&... args); // O(N) weak
+
+    iterator erase(const_iterator pos);     // O(N) weak
+
+    iterator erase(const_iterator first, const_iterator last); // O(N) weak
+
+    template<typename Predicate>
+    size_t erase_if(Predicate pred);        // O(N) weak
+
+    iterator erase_unordered(const_iterator pos); // O(1) weak
+
+private:
+    typedef vector<T> base;
+
+    T *inline_data();
+
+    size_t grown_capacity() const;
+
+    template<typename Construct>
+    void grow_gap(size_t position, size_t k, Construct construct);
+
+    template<typename InputIt>
+    void insert_range(size_t position, InputIt first, InputIt last, std::input_iterator_tag);
+    template<typename ForwardIt>
+    void insert_range(size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+    void change_buf(size_t new_capacity);
+
+    void release();
+    void take_heap(small_vector &other);
+
+private:
+    T *data_;
+    size_t size_;
+    size_t capacity_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_[N];
+};
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector() :
+        data_(inline_data()),
+        size_(0),
+        capacity_(N) {}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(small_vector const &other) :
+        data_(inline_data()),
+        size_(0),
+        capacity_(N) {
+    if (other.size_ > N) {
+        data_ = base::my_alloc(other.size_);
+        capacity_ = other.size_;
+    }
+    try {
+        std::uninitialized_copy(other.data_, other.data_ + other.size_, data_);
+    } catch (...) {
+        release();
+        throw;
+    }
+    size_ = other.size_;
+}
+
+//a heap buffer is taken over, inline elements are moved (copied if their move can throw);
+//either way other is left empty
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(small_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) :
+        data_(inline_data()),
+        size_(0),
+        capacity_(N) {
+    if (!other.is_inline()) {
+        take_heap(other);
+        return;
+    }
+    base::move_elements(data_, other.data_, other.size_);
+    size_ = other.size_;
+    other.clear();
+}
+
+template<typename T, size_t N>
+small_vector<T, N> &small_vector<T, N>::operator=(small_vector const &other) {
+    if (this != &other) {
+        small_vector(other).swap(*this);
+    }
+    return *this;
+}
+
+//ends up where a move construction would: on other's heap buffer or inline
+template<typename T, size_t N>
+small_vector<T, N> &small_vector<T, N>::operator=(small_vector &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    release();
+    if (!other.is_inline()) {
+        take_heap(other);
+        return *this;
+    }
+    base::move_elements(data_, other.data_, other.size_);
+    size_ = other.size_;
+    other.clear();
+    return *this;
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::~small_vector() {
+    clear();
+    release();
+}
+
+template<typename T, size_t N>
+T &small_vector<T, N>::operator[](size_t i) {
+    return data_[i];
+}
+
+template<typename T, size_t N>
+T const &small_vector<T, N>::operator[](size_t i) const {
+    return data_[i];
+}
+
+template<typename T, size_t N>
+T *small_vector<T, N>::data() {
+    return data_;
+}
+
+template<typename T, size_t N>
+T const *small_vector<T, N>::data() const {
+    return data_;
+}
+
+template<typename T, size_t N>
+size_t small_vector<T, N>::size() const {
+    return size_;
+}
+
+template<typename T, size_t N>
+T &small_vector<T, N>::front() {
+    return data_[0];
+}
+
+template<typename T, size_t N>
+T const &small_vector<T, N>::front() const {
+    return data_[0];
+}
+
+template<typename T, size_t N>
+T &small_vector<T, N>::back() {
+    return data_[size_ - 1];
+}
+
+template<typename T, size_t N>
+T const &small_vector<T, N>::back() const {
+    return data_[size_ - 1];
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::push_back(T const &element) {
+    emplace_back(element);
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::push_back(T &&element) {
+    emplace_back(std::move(element));
+}
+
+//args may refer to an element: on growth it is constructed before the old buffer goes
+template<typename T, size_t N>
+template<typename... Args>
+T &small_vector<T, N>::emplace_back(Args &&... args) {
+    if (size_ == capacity_) {
+        grow_gap(size_, 1, [&](T *gap) {
+            new(gap) T(std::forward<Args>(args)...);
+        });
+    } else {
+        new(data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+    }
+    return back();
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::pop_back() {
+    data_[size_ - 1].~T();
+    size_--;
+}
+
+template<typename T, size_t N>
+bool small_vector<T, N>::empty() const {
+    return size_ == 0;
+}
+
+template<typename T, size_t N>
+bool small_vector<T, N>::is_inline() const {
+    return data_ == reinterpret_cast<T const *>(storage_);
+}
+
+template<typename T, size_t N>
+size_t small_vector<T, N>::capacity() const {
+    return capacity_;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+        change_buf(new_capacity);
+    }
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::shrink_to_fit() {
+    if (!is_inline() && size_ < capacity_) {
+        change_buf(size_);
+    }
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::clear() {
+    base::destroy_elements(data_, size_);
+    size_ = 0;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::swap(small_vector &other) {
+    if (!is_inline() && !other.is_inline()) {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    } else if (!is_inline()) {
+        other.swap(*this);
+    } else if (!other.is_inline()) {
+        //our elements fit into the unused inline storage of other, which gives us its buffer
+        base::move_elements(other.inline_data(), data_, size_);
+        base::destroy_elements(data_, size_);
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inline_data();
+        other.capacity_ = N;
+        std::swap(size_, other.size_);
+    } else {
+        small_vector &longer = size_ < other.size_ ? other : *this;
+        small_vector &shorter = size_ < other.size_ ? *this : other;
+        size_t common = shorter.size_;
+        std::swap_ranges(data_, data_ + common, other.data_);
+        base::move_elements(shorter.data_ + common, longer.data_ + common, longer.size_ - common);
+        base::destroy_elements(longer.data_ + common, longer.size_ - common);
+        shorter.size_ = longer.size_;
+        longer.size_ = common;
+    }
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::begin() {
+    return data_;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::end() {
+    return data_ + size_;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::begin() const {
+    return data_;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::end() const {
+    return data_ + size_;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, T const &element) {
+    return emplace(pos, element);
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, T &&element) {
+    return emplace(pos, std::move(element));
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, size_t n, T const &value) {
+    size_t position = pos - data_;
+    if (n == 0) {
+        return data_ + position;
+    }
+    if (capacity_ - size_ < n) {
+        grow_gap(position, n, [&](T *gap) {
+            std::uninitialized_fill_n(gap, n, value);
+        });
+    } else {
+        //value may be one of the elements that are about to move
+        T copy(value);
+        base::insert_copies_in_place(data_, size_, position, n, copy);
+    }
+    return data_ + position;
+}
+
+//first and last must not point into this vector
+template<typename T, size_t N>
+template<typename InputIt, typename>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t position = pos - data_;
+    insert_range(position, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    return data_ + position;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, std::initializer_list<T> list) {
+    return insert(pos, list.begin(), list.end());
+}
+
+template<typename T, size_t N>
+template<typename... Args>
+typename small_vector<T, N>::iterator small_vector<T, N>::emplace(const_iterator pos, Args &&... args) {
+    size_t position = pos - data_;
+    if (size_ == capacity_) {
+        grow_gap(position, 1, [&](T *gap) {
+            new(gap) T(std::forward<Args>(args)...);
+        });
+    } else if (position == size_) {
+        new(data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+    } else {
+        T value(std::forward<Args>(args)...);
+        base::insert_range_in_place(data_, size_, position, std::make_move_iterator(&value),
+                                    std::make_move_iterator(&value + 1), 1);
+    }
+    return data_ + position;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::erase(const_iterator first, const_iterator last) {
+    assert(data_ <= first && last <= data_ + size_);
+    iterator pos = first - data_ + data_;
+    ptrdiff_t delt = last - first;
+    if (delt <= 0) {
+        return pos;
+    }
+    base::move_down(pos, pos + delt, data_ + size_);
+    base::destroy_elements(data_ + size_ - delt, delt);
+    size_ -= delt;
+    return pos;
+}
+
+template<typename T, size_t N>
+template<typename Predicate>
+size_t small_vector<T, N>::erase_if(Predicate pred) {
+    iterator new_end = std::remove_if(begin(), end(), pred);
+    size_t erased = end() - new_end;
+    base::destroy_elements(new_end, erased);
+    size_ -= erased;
+    return erased;
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::erase_unordered(const_iterator pos) {
+    assert(data_ <= pos && pos < data_ + size_);
+    iterator p = pos - data_ + data_;
+    if (p != data_ + size_ - 1) {
+        *p = std::move(back());
+    }
+    pop_back();
+    return p;
+}
+
+template<typename T, size_t N>
+T *small_vector<T, N>::inline_data() {
+    return reinterpret_cast<T *>(storage_);
+}
+
+template<typename T, size_t N>
+size_t small_vector<T, N>::grown_capacity() const {
+    return 2 * capacity_;
+}
+
+//O(N + k) strong unless T is a move-only type with a throwing move constructor
+//always leaves the inline storage: the gap only opens when the current buffer is too small
+template<typename T, size_t N>
+template<typename Construct>
+void small_vector<T, N>::grow_gap(size_t position, size_t k, Construct construct) {
+    size_t new_capacity = std::max(grown_capacity(), size_ + k);
+    T *new_data = base::my_alloc(new_capacity);
+    try {
+        base::build_with_gap(new_data, data_, size_, position, k, construct);
+    } catch (...) {
+        base::my_free(new_data, new_capacity);
+        throw;
+    }
+    base::destroy_elements(data_, size_);
+    release();
+    data_ = new_data;
+    capacity_ = new_capacity;
+    size_ += k;
+}
+
+//O(N + k) weak
+template<typename T, size_t N>
+template<typename InputIt>
+void small_vector<T, N>::insert_range(size_t position, InputIt first, InputIt last, std::input_iterator_tag) {
+    size_t old_size = size_;
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (...) {
+        while (size_ != old_size) {
+            pop_back();
+        }
+        throw;
+    }
+    std::rotate(data_ + position, data_ + old_size, data_ + size_);
+}
+
+//O(N + k) strong on growth, weak otherwise
+template<typename T, size_t N>
+template<typename ForwardIt>
+void small_vector<T, N>::insert_range(size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    size_t k = std::distance(first, last);
+    if (k == 0) {
+        return;
+    }
+    if (capacity_ - size_ < k) {
+        grow_gap(position, k, [&](T *gap) {
+            std::uninitialized_copy(first, last, gap);
+        });
+    } else {
+        base::insert_range_in_place(data_, size_, position, first, last, k);
+    }
+}
+
+//O(N) strong
+//a capacity of at most N moves the elements back inline
+template<typename T, size_t N>
+void small_vector<T, N>::change_buf(size_t new_capacity) {
+    bool to_inline = new_capacity <= N;
+    T *new_data = to_inline ? inline_data() : base::my_alloc(new_capacity);
+    try {
+        base::move_elements(new_data, data_, size_);
+    } catch (...) {
+        if (!to_inline) {
+            base::my_free(new_data, new_capacity);
+        }
+        throw;
+    }
+    base::destroy_elements(data_, size_);
+    release();
+    data_ = new_data;
+    capacity_ = to_inline ? N : new_capacity;
+}
+
+//other's heap buffer and elements become ours, other is left empty and inline;
+//we must hold no buffer or elements of our own
+template<typename T, size_t N>
+void small_vector<T, N>::take_heap(small_vector &other) {
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.data_ = other.inline_data();
+    other.size_ = 0;
+    other.capacity_ = N;
+}
+
+//frees a heap buffer, the elements must be destroyed already
+template<typename T, size_t N>
+void small_vector<T, N>::release() {
+    if (!is_inline()) {
+        base::my_free(data_, capacity_);
+        data_ = inline_data();
+        capacity_ = N;
+    }
+}
+
+#endif // SMALL_VECTOR_H
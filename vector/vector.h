@@ -2,21 +2,153 @@
 #define VECTOR_H
 
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include <cassert>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
-template<typename T>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// from this many bytes on, the buffers of trivially copyable elements in std::allocator
+// vectors are anonymous mappings backed by transparent huge pages; 0 keeps them in malloc
+#ifndef VECTOR_MMAP_THRESHOLD
+#define VECTOR_MMAP_THRESHOLD (32ul << 20)
+#endif
+
+#if defined(__linux__) && VECTOR_MMAP_THRESHOLD != 0
+#include <sys/mman.h>
+#define VECTOR_MMAP 1
+#endif
+
+namespace vector_detail {
+// keeps a stateless allocator from taking space in the vector
+template<typename Allocator>
+struct allocator_holder : private Allocator {
+    explicit allocator_holder(Allocator const &alloc) : Allocator(alloc) {}
+
+    Allocator &allocator() { return *this; }
+    Allocator const &allocator() const { return *this; }
+};
+
+// free templates, so that allocators which never propagate need not be swappable
+template<typename Allocator>
+void swap_allocators(Allocator &a, Allocator &b, std::true_type) {
+    using std::swap;
+    swap(a, b);
+}
+
+template<typename Allocator>
+void swap_allocators(Allocator &, Allocator &, std::false_type) {}
+
+#ifdef VECTOR_MMAP
+size_t const page_size = 4096;
+
+inline size_t mapping_length(size_t bytes) {
+    return (bytes + page_size - 1) / page_size * page_size;
+}
+
+// only a hint, without THP support the mapping keeps base pages
+inline void advise_huge_pages(void *p, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+    madvise(p, mapping_length(bytes), MADV_HUGEPAGE);
+#else
+    (void) p;
+    (void) bytes;
+#endif
+}
+
+inline void *map_pages(size_t bytes) {
+    void *p = mmap(nullptr, mapping_length(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    advise_huge_pages(p, bytes);
+    return p;
+}
+
+// the kernel moves page table entries instead of copying, on failure p stays mapped
+inline void *remap_pages(void *p, size_t old_bytes, size_t new_bytes) {
+    void *q = mremap(p, mapping_length(old_bytes), mapping_length(new_bytes), MREMAP_MAYMOVE);
+    if (q == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    advise_huge_pages(q, new_bytes);
+    return q;
+}
+
+inline void unmap_pages(void *p, size_t bytes) {
+    munmap(p, mapping_length(bytes));
+}
+#endif
+}
+
+// Growth policies: next_capacity(capacity, element_size) is what a full vector of
+// that capacity grows to. Smaller factors waste less memory and copy more often.
+struct growth_factor_2 {
+    static size_t next_capacity(size_t capacity, size_t) {
+        return capacity == 0 ? 4 : 2 * capacity;
+    }
+};
+
+struct growth_factor_1_5 {
+    static size_t next_capacity(size_t capacity, size_t) {
+        return capacity < 4 ? 4 : capacity + capacity / 2;
+    }
+};
+
+// 1.6, just under the golden ratio: the blocks freed by earlier growth eventually
+// add up to more than the next request, so an allocator can reuse them
+struct growth_golden {
+    static size_t next_capacity(size_t capacity, size_t) {
+        return capacity < 4 ? 4 : capacity + capacity / 5 * 3 + capacity % 5 * 3 / 5;
+    }
+};
+
+// Growth grows the buffer until it reaches ThresholdBytes, from there the size is
+// rounded up to whole pages, so the tail of the last page is not wasted
+template<typename Growth = growth_factor_1_5, size_t ThresholdBytes = 128 * 1024, size_t PageSize = 4096>
+struct growth_page_rounded {
+    static size_t next_capacity(size_t capacity, size_t element_size) {
+        size_t next = Growth::next_capacity(capacity, element_size);
+        size_t bytes = next * element_size;
+        if (bytes < ThresholdBytes) {
+            return next;
+        }
+        return (bytes + PageSize - 1) / PageSize * PageSize / element_size;
+    }
+};
+
+// Allocator is used through std::allocator_traits and follows its propagate_on_container_*
+// traits; its pointer type must be T *. Elements are constructed with placement new, not
+// allocator_traits::construct.
+template<typename T, typename Allocator = std::allocator<T>, typename Growth = growth_factor_2>
+struct vector : private vector_detail::allocator_holder<Allocator> {
+    static_assert(std::is_same<typename Allocator::value_type, T>::value, "Allocator must allocate T");
 
-struct vector {
     using iterator = T *;
     using const_iterator = T const *;
+    using allocator_type = Allocator;
 
     vector();                               // O(1) nothrow
+    explicit vector(Allocator const &);     // O(1) nothrow
     vector(vector const &);                  // O(N) strong
+    vector(vector const &, Allocator const &); // O(N) strong
+    vector(vector &&) noexcept;             // O(1) nothrow
     vector &operator=(vector const &other); // O(N) strong
+    vector &operator=(vector &&other);      // O(1) nothrow, O(N) basic for unequal allocators that stay
 
     ~vector();                              // O(N) nothrow
 
+    Allocator get_allocator() const;        // O(1) nothrow
+
     T &operator[](size_t i);                // O(1) nothrow
     T const &operator[](size_t i) const;    // O(1) nothrow
 
@@ -30,6 +162,9 @@ struct vector {
     T &back();                              // O(1) nothrow
     T const &back() const;                  // O(1) nothrow
     void push_back(T const &);               // O(1)* strong
+    void push_back(T &&);                    // O(1)* strong
+    template<typename... Args>
+    T &emplace_back(Args &&... args);        // O(1)* strong
     void pop_back();                        // O(1) nothrow
 
     bool empty() const;                     // O(1) nothrow
@@ -38,9 +173,13 @@ struct vector {
     void reserve(size_t);                   // O(N) strong
     void shrink_to_fit();                   // O(N) strong
 
+    void resize(size_t);                    // O(N) strong, new elements are value-initialized
+    void resize(size_t, T const &);         // O(N) strong
+    void resize_for_overwrite(size_t);      // O(N) strong, new trivial elements are left uninitialized
+
     void clear();                           // O(N) nothrow
 
-    void swap(vector &);                     // O(1) nothrow
+    void swap(vector &);                     // O(1) nothrow, allocators must be equal unless they propagate
 
     iterator begin();                       // O(1) nothrow
     iterator end();                         // O(1) nothrow
@@ -49,21 +188,136 @@ struct vector {
     const_iterator end() const;             // O(1) nothrow
 
     iterator insert(const_iterator pos, T const &); // O(N) weak
+    iterator insert(const_iterator pos, T &&);      // O(N) weak
+    iterator insert(const_iterator pos, size_t n, T const &); // O(N + n) weak
+    template<typename InputIt,
+            typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last); // O(N + k) weak
+    iterator insert(const_iterator pos, std::initializer_list<T>);     // O(N + k) weak
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args &&... args); // O(N) weak
 
     iterator erase(const_iterator pos);     // O(N) weak
 
     iterator erase(const_iterator first, const_iterator last); // O(N) weak
 
+    template<typename Predicate>
+    size_t erase_if(Predicate pred);        // O(N) weak
+
+    iterator erase_unordered(const_iterator pos); // O(1) weak
+
 private:
-    void increase_capacity();
+    typedef std::allocator_traits<Allocator> traits;
+    static_assert(std::is_same<typename traits::pointer, T *>::value, "fancy pointers are not supported");
+
+    // trivially copyable elements are copied with memcpy and never destroyed one by one
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> trivial;
+    // std::allocator is bypassed: its trivial elements live in malloc'ed storage, so that
+    // growth can extend the buffer with realloc (or in a mapping extended with mremap, see
+    // VECTOR_MMAP_THRESHOLD); other allocators get no such shortcut
+    typedef std::is_same<Allocator, std::allocator<T>> default_allocator;
+    typedef std::integral_constant<bool, trivial::value && default_allocator::value> reallocatable;
+
+    using vector_detail::allocator_holder<Allocator>::allocator;
+
+    void swap_storage(vector &other);
+    void move_assign(vector &other, std::true_type);
+    void move_assign(vector &other, std::false_type);
+
+    T *allocate(size_t size);
+    T *allocate(size_t size, std::true_type);
+    T *allocate(size_t size, std::false_type);
+
+    void deallocate(T *data, size_t capacity);
+    void deallocate(T *data, size_t capacity, std::true_type);
+    void deallocate(T *data, size_t capacity, std::false_type);
+
+    size_t grown_capacity() const;
+
+    template<typename... Args>
+    void realloc_insert(size_t position, Args &&... args);
+    template<typename... Args>
+    void realloc_insert(size_t position, std::true_type, Args &&... args);
+    template<typename... Args>
+    void realloc_insert(size_t position, std::false_type, Args &&... args);
+
+    template<typename Construct>
+    void realloc_gap(size_t position, size_t k, Construct construct);
+
+    void insert_copies(size_t position, size_t n, T const &value);
+
+    template<typename Construct>
+    void resize_with(size_t n, Construct construct);
+    void truncate(size_t n);
+
+    static void value_construct(T *data, size_t k);
+    static void default_construct(T *data, size_t k);
+
+    template<typename InputIt>
+    void insert_range(size_t position, InputIt first, InputIt last, std::input_iterator_tag);
+    template<typename ForwardIt>
+    void insert_range(size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+    // the helpers below only see a buffer and a size, small_vector shares them
+    // (my_alloc and my_free are the std::allocator storage)
+
+    template<typename, size_t>
+    friend struct small_vector;
+
+    template<typename Construct>
+    static void build_with_gap(T *new_data, T *old_data, size_t size, size_t position, size_t k,
+                               Construct construct);
+
+    static void insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value);
+    static void insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value,
+                                       std::true_type);
+    static void insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value,
+                                       std::false_type);
+
+    template<typename ForwardIt>
+    static void insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k);
+    template<typename ForwardIt>
+    static void insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k, std::true_type);
+    template<typename ForwardIt>
+    static void insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k, std::false_type);
 
     static void destroy_elements(T const *start, size_t size);
+    static void destroy_elements(T const *start, size_t size, std::true_type);
+    static void destroy_elements(T const *start, size_t size, std::false_type);
 
     void change_buf(size_t new_capacity);
+    void change_buf(size_t new_capacity, std::true_type);
+    void change_buf(size_t new_capacity, std::false_type);
 
     static T *my_alloc(size_t size);
+    static T *my_alloc(size_t size, std::true_type);
+    static T *my_alloc(size_t size, std::false_type);
+
+    static void my_free(T *data, size_t capacity);
+    static void my_free(T *data, size_t capacity, std::true_type);
+    static void my_free(T *data, size_t capacity, std::false_type);
+
+    // whether my_alloc maps a buffer of this capacity, rather than taking it from malloc
+    static bool mapped(size_t capacity);
+    // a grown mapping is extended to its last page
+    static size_t mapped_capacity(size_t capacity);
+
+    T *copy_buf(size_t capacity, T const *old_buf, size_t size);
+    T *copy_buf(size_t capacity, T const *old_buf, size_t size, std::true_type);
+    T *copy_buf(size_t capacity, T const *old_buf, size_t size, std::false_type);
 
-    static T *copy_buf(size_t capacity, T *old_buf, size_t size);
+    T *move_buf(size_t capacity, T *old_buf, size_t size);
+
+    static void move_down(T *dst, T *first, T *last);
+    static void move_down(T *dst, T *first, T *last, std::true_type);
+    static void move_down(T *dst, T *first, T *last, std::false_type);
+
+    static void move_elements(T *dst, T *src, size_t size);
+    static void move_elements(T *dst, T *src, size_t size, std::true_type);
+    static void move_elements(T *dst, T *src, size_t size, std::false_type);
 
 private:
     T *data_;
@@ -71,218 +325,829 @@ private:
     size_t capacity_;
 };
 
-template<typename T>
-vector<T>::vector() :
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector() :
+        vector(Allocator()) {}
+
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(Allocator const &alloc) :
+        vector_detail::allocator_holder<Allocator>(alloc),
         data_(nullptr),
         size_(0),
         capacity_(0) {}
 
-template<typename T>
-vector<T>::vector(const vector<T> &other) :
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector const &other) :
+        vector(other, traits::select_on_container_copy_construction(other.allocator())) {}
+
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector const &other, Allocator const &alloc) :
+        vector_detail::allocator_holder<Allocator>(alloc),
+        data_(nullptr),
         size_(other.size_),
-        capacity_(size_),
-        data_(nullptr) {
+        capacity_(other.size_) {
     data_ = copy_buf(size_, other.data_, size_);
 }
 
-template<typename T>
-void vector<T>::swap(vector &other) {
-    std::swap(data_, other.data_);
-    std::swap(size_, other.size_);
-    std::swap(capacity_, other.capacity_);
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector &&other) noexcept :
+        vector_detail::allocator_holder<Allocator>(std::move(other.allocator())),
+        data_(other.data_),
+        size_(other.size_),
+        capacity_(other.capacity_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::swap(vector &other) {
+    assert(traits::propagate_on_container_swap::value || allocator() == other.allocator());
+    swap_storage(other);
+    vector_detail::swap_allocators(allocator(), other.allocator(), typename traits::propagate_on_container_swap());
 }
 
-template<typename T>
-vector<T> &vector<T>::operator=(vector<T> const &other) {
-    vector<T>(other).swap(*this);
+//the copy is made with the allocator this vector ends up with
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth> &vector<T, Allocator, Growth>::operator=(vector const &other) {
+    typename traits::propagate_on_container_copy_assignment propagate;
+    vector copy(other, propagate ? other.allocator() : allocator());
+    swap_storage(copy);
+    vector_detail::swap_allocators(allocator(), copy.allocator(), propagate);
     return *this;
 }
 
-template<typename T>
-vector<T>::~vector<T>() {
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth> &vector<T, Allocator, Growth>::operator=(vector &&other) {
+    if (this != &other) {
+        move_assign(other, typename traits::propagate_on_container_move_assignment());
+    }
+    return *this;
+}
+
+template<typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::~vector() {
     clear();
-    operator delete(data_);
+    deallocate(data_, capacity_);
+}
+
+template<typename T, typename Allocator, typename Growth>
+Allocator vector<T, Allocator, Growth>::get_allocator() const {
+    return allocator();
 }
 
-template<typename T>
-T &vector<T>::operator[](size_t i) {
+template<typename T, typename Allocator, typename Growth>
+T &vector<T, Allocator, Growth>::operator[](size_t i) {
     return data_[i];
 }
 
-template<typename T>
-T const &vector<T>::operator[](size_t i) const {
+template<typename T, typename Allocator, typename Growth>
+T const &vector<T, Allocator, Growth>::operator[](size_t i) const {
     return data_[i];
 }
 
-template<typename T>
-T *vector<T>::data() {
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::data() {
     return data_;
 }
 
-template<typename T>
-T const *vector<T>::data() const {
+template<typename T, typename Allocator, typename Growth>
+T const *vector<T, Allocator, Growth>::data() const {
     return data_;
 }
 
-template<typename T>
-size_t vector<T>::size() const {
+template<typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::size() const {
     return size_;
 }
 
-template<typename T>
-T &vector<T>::front() {
+template<typename T, typename Allocator, typename Growth>
+T &vector<T, Allocator, Growth>::front() {
     return data_[0];
 }
 
-template<typename T>
-T const &vector<T>::front() const {
+template<typename T, typename Allocator, typename Growth>
+T const &vector<T, Allocator, Growth>::front() const {
     return data_[0];
 }
 
-template<typename T>
-T &vector<T>::back() {
+template<typename T, typename Allocator, typename Growth>
+T &vector<T, Allocator, Growth>::back() {
     return data_[size_ - 1];
 }
 
-template<typename T>
-T const &vector<T>::back() const {
+template<typename T, typename Allocator, typename Growth>
+T const &vector<T, Allocator, Growth>::back() const {
     return data_[size_ - 1];
 }
 
-template<typename T>
-void vector<T>::push_back(const T &element) {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(const T &element) {
+    emplace_back(element);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(T &&element) {
+    emplace_back(std::move(element));
+}
+
+//args may refer to an element of this vector: on growth the new element is
+//constructed before the old buffer is released
+template<typename T, typename Allocator, typename Growth>
+template<typename... Args>
+T &vector<T, Allocator, Growth>::emplace_back(Args &&... args) {
     if (size_ == capacity_) {
-        T copy = element;
-        increase_capacity();
-        new(data_ + size_)T(copy);
+        realloc_insert(size_, std::forward<Args>(args)...);
     } else {
-        new(data_ + size_)T(element);
+        new(data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
     }
-    size_++;
+    return back();
+}
+
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, const T &element) {
+    return emplace(pos, element);
+}
+
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, T &&element) {
+    return emplace(pos, std::move(element));
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos, const T &element) {
-    ptrdiff_t position = pos - data_;
-    push_back(element);
-    iterator realPos = data_ + position;
-    for (iterator ind = data_ + size_ - 1; ind != realPos; ind--) {
-        std::swap(*ind, *(ind - 1));
+//strong on growth and at the end; otherwise the new element is built aside first,
+//since shifting the tail may overwrite what args refer to
+template<typename T, typename Allocator, typename Growth>
+template<typename... Args>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::emplace(const_iterator pos, Args &&... args) {
+    size_t position = pos - data_;
+    if (size_ == capacity_) {
+        realloc_insert(position, std::forward<Args>(args)...);
+    } else if (position == size_) {
+        new(data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+    } else {
+        T value(std::forward<Args>(args)...);
+        new(data_ + size_) T(std::move(data_[size_ - 1]));
+        size_++;
+        std::move_backward(data_ + position, data_ + size_ - 2, data_ + size_ - 1);
+        data_[position] = std::move(value);
     }
-    return realPos;
+    return data_ + position;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, size_t n, T const &value) {
+    size_t position = pos - data_;
+    if (n != 0) {
+        insert_copies(position, n, value);
+    }
+    return data_ + position;
+}
+
+//first and last must not point into this vector
+template<typename T, typename Allocator, typename Growth>
+template<typename InputIt, typename>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t position = pos - data_;
+    insert_range(position, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    return data_ + position;
+}
+
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, std::initializer_list<T> list) {
+    return insert(pos, list.begin(), list.end());
+}
+
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::erase(const_iterator pos) {
     return erase(pos, pos + 1);
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator last) {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::erase(const_iterator first, const_iterator last) {
     assert(data_ <= first && last <= data_ + size_);
     ptrdiff_t delt = last - first;
     if (delt <= 0) {
         return last - data_ + data_;
     }
-    for (ptrdiff_t i = first - data_; i < size_ - delt; i++) {
-        data_[i] = data_[i + delt];
-    }
+    iterator pos = first - data_ + data_;
+    move_down(pos, pos + delt, data_ + size_);
     destroy_elements(data_ + size_ - delt, delt);
     size_ -= delt;
-    return first - data_ + data_;
+    return pos;
+}
+
+//one pass: the kept elements are moved down over the removed ones, then the tail is destroyed
+//returns the number of erased elements
+template<typename T, typename Allocator, typename Growth>
+template<typename Predicate>
+size_t vector<T, Allocator, Growth>::erase_if(Predicate pred) {
+    iterator new_end = std::remove_if(begin(), end(), pred);
+    size_t erased = end() - new_end;
+    destroy_elements(new_end, erased);
+    size_ -= erased;
+    return erased;
 }
 
-template<typename T>
-bool vector<T>::empty() const {
+//the last element is moved into pos, so the order of the others is not kept
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::erase_unordered(const_iterator pos) {
+    assert(data_ <= pos && pos < data_ + size_);
+    iterator p = pos - data_ + data_;
+    if (p != data_ + size_ - 1) {
+        *p = std::move(back());
+    }
+    pop_back();
+    return p;
+}
+
+template<typename T, typename Allocator, typename Growth>
+bool vector<T, Allocator, Growth>::empty() const {
     return size_ == 0;
 }
 
-template<typename T>
-size_t vector<T>::capacity() const {
+template<typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::capacity() const {
     return capacity_;
 }
 
-template<typename T>
-void vector<T>::reserve(size_t new_capacity) {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::reserve(size_t new_capacity) {
     if (new_capacity > capacity_) {
         change_buf(new_capacity);
     }
 }
 
-template<typename T>
-void vector<T>::pop_back() {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::pop_back() {
     data_[size_ - 1].~T();
     size_--;
 }
 
-template<typename T>
-void vector<T>::shrink_to_fit() {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::shrink_to_fit() {
     if (size_ < capacity_) {
         change_buf(size_);
     }
 }
 
-template<typename T>
-void vector<T>::clear() {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::resize(size_t n) {
+    resize_with(n, value_construct);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::resize(size_t n, T const &value) {
+    if (n <= size_) {
+        truncate(n);
+    } else {
+        insert_copies(size_, n - size_, value);
+    }
+}
+
+//for buffers about to be filled by read(), a decoder and the like: trivial elements
+//get no zeroing pass, the others are default-constructed
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::resize_for_overwrite(size_t n) {
+    resize_with(n, default_construct);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::clear() {
     destroy_elements(data_, size_);
     size_ = 0;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::begin() {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::begin() {
     return data_;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::end() {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::end() {
     return data_ + size_;
 }
 
-template<typename T>
-typename vector<T>::const_iterator vector<T>::begin() const {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::begin() const {
     return data_;
 }
 
-template<typename T>
-typename vector<T>::const_iterator vector<T>::end() const {
+template<typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::end() const {
     return data_ + size_;
 }
 
-template<typename T>
-void vector<T>::destroy_elements(T const *start, size_t size) {
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::destroy_elements(T const *start, size_t size) {
+    destroy_elements(start, size, trivial());
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::destroy_elements(T const *, size_t, std::true_type) {}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::destroy_elements(T const *start, size_t size, std::false_type) {
     for (size_t i = size; i != 0; i--) {
         start[i - 1].~T();
     }
 }
 
-template<typename T>
-void vector<T>::increase_capacity() {
-    if (size_ == capacity_) {
-        reserve(capacity_ == 0 ? 4 : 2 * capacity_);
+template<typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::grown_capacity() const {
+    return Growth::next_capacity(capacity_, sizeof(T));
+}
+
+template<typename T, typename Allocator, typename Growth>
+template<typename... Args>
+void vector<T, Allocator, Growth>::realloc_insert(size_t position, Args &&... args) {
+    realloc_insert(position, reallocatable(), std::forward<Args>(args)...);
+}
+
+//O(N) strong
+//the value is built before realloc, which may move the buffer args point into
+template<typename T, typename Allocator, typename Growth>
+template<typename... Args>
+void vector<T, Allocator, Growth>::realloc_insert(size_t position, std::true_type, Args &&... args) {
+    T value(std::forward<Args>(args)...);
+    change_buf(grown_capacity(), std::true_type());
+    if (position != size_) {
+        std::memmove(data_ + position + 1, data_ + position, (size_ - position) * sizeof(T));
+    }
+    new(data_ + position) T(value);
+    size_++;
+}
+
+template<typename T, typename Allocator, typename Growth>
+template<typename... Args>
+void vector<T, Allocator, Growth>::realloc_insert(size_t position, std::false_type, Args &&... args) {
+    realloc_gap(position, 1, [&](T *gap) {
+        new(gap) T(std::forward<Args>(args)...);
+    });
+}
+
+//O(N + k) strong unless T is a move-only type with a throwing move constructor
+template<typename T, typename Allocator, typename Growth>
+template<typename Construct>
+void vector<T, Allocator, Growth>::realloc_gap(size_t position, size_t k, Construct construct) {
+    size_t new_capacity = std::max(grown_capacity(), size_ + k);
+    T *new_data = allocate(new_capacity);
+    try {
+        build_with_gap(new_data, data_, size_, position, k, construct);
+    } catch (...) {
+        deallocate(new_data, new_capacity);
+        throw;
+    }
+    destroy_elements(data_, size_);
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+    size_ += k;
+}
+
+//O(N + n) strong on growth, weak otherwise
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::insert_copies(size_t position, size_t n, T const &value) {
+    if (capacity_ - size_ < n && !reallocatable::value) {
+        realloc_gap(position, n, [&](T *gap) {
+            std::uninitialized_fill_n(gap, n, value);
+        });
+        return;
+    }
+    //value may be one of the elements that are about to move
+    T copy(value);
+    if (capacity_ - size_ < n) {
+        change_buf(std::max(grown_capacity(), size_ + n));
+    }
+    insert_copies_in_place(data_, size_, position, n, copy);
+}
+
+//O(N + k) strong: construct(gap, k) fills the new tail, strong itself
+//growth follows Growth like push_back, so repeated resizes stay amortized O(1) per element
+template<typename T, typename Allocator, typename Growth>
+template<typename Construct>
+void vector<T, Allocator, Growth>::resize_with(size_t n, Construct construct) {
+    if (n <= size_) {
+        truncate(n);
+        return;
+    }
+    size_t k = n - size_;
+    if (capacity_ < n) {
+        if (!reallocatable::value) {
+            realloc_gap(size_, k, [&](T *gap) {
+                construct(gap, k);
+            });
+            return;
+        }
+        change_buf(std::max(grown_capacity(), n));
+    }
+    construct(data_ + size_, k);
+    size_ = n;
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::truncate(size_t n) {
+    destroy_elements(data_ + n, size_ - n);
+    size_ = n;
+}
+
+//O(k) strong
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::value_construct(T *data, size_t k) {
+    size_t i = 0;
+    try {
+        for (; i != k; i++) {
+            new(data + i) T();
+        }
+    } catch (...) {
+        destroy_elements(data, i);
+        throw;
+    }
+}
+
+//O(k) strong, nothing at all for trivially default constructible T
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::default_construct(T *data, size_t k) {
+    size_t i = 0;
+    try {
+        for (; i != k; i++) {
+            new(data + i) T;
+        }
+    } catch (...) {
+        destroy_elements(data, i);
+        throw;
+    }
+}
+
+//O(N + k) weak
+//a single pass range has no size up front: it is appended and rotated into place
+template<typename T, typename Allocator, typename Growth>
+template<typename InputIt>
+void vector<T, Allocator, Growth>::insert_range(size_t position, InputIt first, InputIt last, std::input_iterator_tag) {
+    size_t old_size = size_;
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (...) {
+        while (size_ != old_size) {
+            pop_back();
+        }
+        throw;
+    }
+    std::rotate(data_ + position, data_ + old_size, data_ + size_);
+}
+
+//O(N + k) strong on growth, weak otherwise
+template<typename T, typename Allocator, typename Growth>
+template<typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_range(size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    size_t k = std::distance(first, last);
+    if (k == 0) {
+        return;
+    }
+    if (capacity_ - size_ < k) {
+        if (!reallocatable::value) {
+            realloc_gap(position, k, [&](T *gap) {
+                std::uninitialized_copy(first, last, gap);
+            });
+            return;
+        }
+        change_buf(std::max(grown_capacity(), size_ + k));
+    }
+    insert_range_in_place(data_, size_, position, first, last, k);
+}
+
+//strong: construct(gap) fills k elements at position of new_data, then the size old
+//elements are moved around them; on failure new_data is left empty and old_data intact
+template<typename T, typename Allocator, typename Growth>
+template<typename Construct>
+void vector<T, Allocator, Growth>::build_with_gap(T *new_data, T *old_data, size_t size, size_t position, size_t k,
+                               Construct construct) {
+    construct(new_data + position);
+    try {
+        move_elements(new_data, old_data, position);
+        try {
+            move_elements(new_data + position + k, old_data + position, size - position);
+        } catch (...) {
+            destroy_elements(new_data, position);
+            throw;
+        }
+    } catch (...) {
+        destroy_elements(new_data + position, k);
+        throw;
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value) {
+    insert_copies_in_place(data, size, position, n, value, trivial());
+}
+
+//strong, the tail moves with one memmove
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value,
+                                       std::true_type) {
+    if (position != size) {
+        std::memmove(data + position + n, data + position, (size - position) * sizeof(T));
+    }
+    std::uninitialized_fill_n(data + position, n, value);
+    size += n;
+}
+
+//weak, value must not be an element of data
+//the tail is moved once: the part that lands past the end is move-constructed there,
+//the rest is shifted with move assignment
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::insert_copies_in_place(T *data, size_t &size, size_t position, size_t n, T const &value,
+                                       std::false_type) {
+    size_t after = size - position;
+    T *old_end = data + size;
+    if (after > n) {
+        std::uninitialized_copy(std::make_move_iterator(old_end - n), std::make_move_iterator(old_end), old_end);
+        size += n;
+        std::move_backward(data + position, old_end - n, old_end);
+        std::fill_n(data + position, n, value);
+    } else {
+        std::uninitialized_fill_n(old_end, n - after, value);
+        size += n - after;
+        std::uninitialized_copy(std::make_move_iterator(data + position), std::make_move_iterator(old_end),
+                                data + size);
+        size += after;
+        std::fill(data + position, old_end, value);
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+template<typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k) {
+    insert_range_in_place(data, size, position, first, last, k, trivial());
+}
+
+//strong, the tail moves with one memmove and back if copying the range throws
+template<typename T, typename Allocator, typename Growth>
+template<typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k, std::true_type) {
+    size_t after = size - position;
+    if (after != 0) {
+        std::memmove(data + position + k, data + position, after * sizeof(T));
+    }
+    try {
+        std::uninitialized_copy(first, last, data + position);
+    } catch (...) {
+        if (after != 0) {
+            std::memmove(data + position, data + position + k, after * sizeof(T));
+        }
+        throw;
+    }
+    size += k;
+}
+
+//weak, the same single shift as insert_copies_in_place
+template<typename T, typename Allocator, typename Growth>
+template<typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_range_in_place(T *data, size_t &size, size_t position, ForwardIt first, ForwardIt last,
+                                      size_t k, std::false_type) {
+    size_t after = size - position;
+    T *old_end = data + size;
+    if (after > k) {
+        std::uninitialized_copy(std::make_move_iterator(old_end - k), std::make_move_iterator(old_end), old_end);
+        size += k;
+        std::move_backward(data + position, old_end - k, old_end);
+        std::copy(first, last, data + position);
+    } else {
+        ForwardIt mid = first;
+        std::advance(mid, after);
+        std::uninitialized_copy(mid, last, old_end);
+        size += k - after;
+        std::uninitialized_copy(std::make_move_iterator(data + position), std::make_move_iterator(old_end),
+                                data + size);
+        size += after;
+        std::copy(first, mid, data + position);
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::swap_storage(vector &other) {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_assign(vector &other, std::true_type) {
+    vector temp(std::move(other));
+    swap_storage(temp);
+    vector_detail::swap_allocators(allocator(), temp.allocator(),
+                                   typename traits::propagate_on_container_move_assignment());
+}
+
+//the buffer of other can only be taken if our allocator is able to free it,
+//otherwise its elements are moved one by one
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_assign(vector &other, std::false_type) {
+    if (allocator() == other.allocator()) {
+        vector temp(allocator());
+        temp.swap_storage(other);
+        swap_storage(temp);
+    } else {
+        vector temp(allocator());
+        temp.reserve(other.size_);
+        temp.insert(temp.end(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        swap_storage(temp);
+        other.clear();
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::change_buf(size_t new_capacity) {
+    change_buf(new_capacity, reallocatable());
+}
+
+//O(N) strong, O(1) when realloc can extend the buffer in place
+//(glibc remaps large buffers with mremap instead of copying them)
+//from VECTOR_MMAP_THRESHOLD on the buffer is a mapping of its own: growing it is an
+//mremap, O(1) in the elements, and only crossing the threshold copies
+//on growth the capacity includes the slack malloc or the last page rounded the block up to,
+//shrink_to_fit stays exact
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::change_buf(size_t new_capacity, std::true_type) {
+    bool grows = new_capacity > capacity_;
+    if (new_capacity == 0) {
+        my_free(data_, capacity_);
+        data_ = nullptr;
+    } else if (mapped(capacity_) && mapped(new_capacity)) {
+#ifdef VECTOR_MMAP
+        data_ = static_cast<T *>(vector_detail::remap_pages(data_, capacity_ * sizeof(T),
+                                                            new_capacity * sizeof(T)));
+#endif
+        if (grows) {
+            new_capacity = mapped_capacity(new_capacity);
+        }
+    } else if (mapped(capacity_) || mapped(new_capacity)) {
+        T *new_data = my_alloc(new_capacity);
+        if (size_ != 0) {
+            std::memcpy(new_data, data_, size_ * sizeof(T));
+        }
+        my_free(data_, capacity_);
+        data_ = new_data;
+        if (grows) {
+            new_capacity = mapped_capacity(new_capacity);
+        }
+    } else {
+        void *temp = std::realloc(data_, new_capacity * sizeof(T));
+        if (temp == nullptr) {
+            throw std::bad_alloc();
+        }
+        data_ = static_cast<T *>(temp);
+#ifdef __GLIBC__
+        size_t usable = malloc_usable_size(data_) / sizeof(T);
+        if (grows && !mapped(usable)) {
+            new_capacity = std::max(new_capacity, usable);
+        }
+#endif
     }
+    capacity_ = new_capacity;
 }
 
 //O(N) strong
-template<typename T>
-void vector<T>::change_buf(size_t new_capacity) {
-    T *temp = copy_buf(new_capacity, data_, size_);
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::change_buf(size_t new_capacity, std::false_type) {
+    T *temp = move_buf(new_capacity, data_, size_);
     destroy_elements(data_, size_);
-    operator delete(data_);
+    deallocate(data_, capacity_);
     data_ = temp;
     capacity_ = new_capacity;
 }
 
-template<typename T>
-T *vector<T>::my_alloc(size_t size) {
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::allocate(size_t size) {
+    return allocate(size, default_allocator());
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::allocate(size_t size, std::true_type) {
+    return my_alloc(size);
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::allocate(size_t size, std::false_type) {
+    return traits::allocate(allocator(), size);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::deallocate(T *data, size_t capacity) {
+    deallocate(data, capacity, default_allocator());
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::deallocate(T *data, size_t capacity, std::true_type) {
+    my_free(data, capacity);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::deallocate(T *data, size_t capacity, std::false_type) {
+    if (data != nullptr) {
+        traits::deallocate(allocator(), data, capacity);
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::my_alloc(size_t size) {
+    return my_alloc(size, trivial());
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::my_alloc(size_t size, std::true_type) {
+#ifdef VECTOR_MMAP
+    if (mapped(size)) {
+        return static_cast<T *>(vector_detail::map_pages(size * sizeof(T)));
+    }
+#endif
+    void *data = std::malloc(size * sizeof(T));
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T *>(data);
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::my_alloc(size_t size, std::false_type) {
     return static_cast<T *>(operator new(size * sizeof(T)));
 }
 
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::my_free(T *data, size_t capacity) {
+    my_free(data, capacity, trivial());
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::my_free(T *data, size_t capacity, std::true_type) {
+#ifdef VECTOR_MMAP
+    if (mapped(capacity)) {
+        vector_detail::unmap_pages(data, capacity * sizeof(T));
+        return;
+    }
+#else
+    (void) capacity;
+#endif
+    std::free(data);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::my_free(T *data, size_t, std::false_type) {
+    operator delete(data);
+}
+
+//the capacity alone tells a mapping from a malloc'ed block, so every capacity
+//recorded for one must stay on its side of the threshold
+template<typename T, typename Allocator, typename Growth>
+bool vector<T, Allocator, Growth>::mapped(size_t capacity) {
+#ifdef VECTOR_MMAP
+    return trivial::value && capacity > (VECTOR_MMAP_THRESHOLD - 1) / sizeof(T);
+#else
+    (void) capacity;
+    return false;
+#endif
+}
+
+template<typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::mapped_capacity(size_t capacity) {
+#ifdef VECTOR_MMAP
+    if (sizeof(T) <= vector_detail::page_size) {
+        return vector_detail::mapping_length(capacity * sizeof(T)) / sizeof(T);
+    }
+#endif
+    return capacity;
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::copy_buf(size_t new_capacity, T const *old_data, size_t size) {
+    return copy_buf(new_capacity, old_data, size, trivial());
+}
+
 //O(n) strong
-template<typename T>
-T *vector<T>::copy_buf(size_t new_capacity, T *old_data, size_t size) {
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::copy_buf(size_t new_capacity, T const *old_data, size_t size, std::true_type) {
     T *new_data = nullptr;
     if (new_capacity != 0) {
-        new_data = my_alloc(new_capacity);
+        new_data = allocate(new_capacity);
+        if (size != 0) {
+            std::memcpy(new_data, old_data, size * sizeof(T));
+        }
+    }
+    return new_data;
+}
+
+//O(n) strong
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::copy_buf(size_t new_capacity, T const *old_data, size_t size, std::false_type) {
+    T *new_data = nullptr;
+    if (new_capacity != 0) {
+        new_data = allocate(new_capacity);
         size_t i = 0;
         try {
             for (; i != size; i++) {
@@ -290,11 +1155,70 @@ T *vector<T>::copy_buf(size_t new_capacity, T *old_data, size_t size) {
             }
         } catch (...) {
             destroy_elements(new_data, i);
-            operator delete(new_data);
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+    }
+    return new_data;
+}
+
+template<typename T, typename Allocator, typename Growth>
+T *vector<T, Allocator, Growth>::move_buf(size_t new_capacity, T *old_data, size_t size) {
+    T *new_data = nullptr;
+    if (new_capacity != 0) {
+        new_data = allocate(new_capacity);
+        try {
+            move_elements(new_data, old_data, size);
+        } catch (...) {
+            deallocate(new_data, new_capacity);
             throw;
         }
     }
     return new_data;
 }
 
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_down(T *dst, T *first, T *last) {
+    move_down(dst, first, last, trivial());
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_down(T *dst, T *first, T *last, std::true_type) {
+    if (first != last) {
+        std::memmove(dst, first, (last - first) * sizeof(T));
+    }
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_down(T *dst, T *first, T *last, std::false_type) {
+    std::move(first, last, dst);
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_elements(T *dst, T *src, size_t size) {
+    move_elements(dst, src, size, trivial());
+}
+
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_elements(T *dst, T *src, size_t size, std::true_type) {
+    if (size != 0) {
+        std::memcpy(dst, src, size * sizeof(T));
+    }
+}
+
+//O(n) strong unless T is a move-only type with a throwing move constructor
+//moves elements only when that cannot throw, so src stays intact on failure
+template<typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_elements(T *dst, T *src, size_t size, std::false_type) {
+    size_t i = 0;
+    try {
+        for (; i != size; i++) {
+            new(dst + i) T(std::move_if_noexcept(src[i]));
+        }
+    } catch (...) {
+        destroy_elements(dst, i);
+        throw;
+    }
+}
+
 #endif // VECTOR_H
@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "vector.h"
+
+// usage: vector_bench
+// Times range and fill insertion into the middle of a vector against std::vector.
+// Every call starts from a copy of the same base vector, so both columns include
+// one copy of it. Then, for every growth policy, the cost of filling a vector with
+// push_back and the share of its final capacity that is left unused.
+namespace {
+template<typename T>
+void do_not_optimize(T const& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// runs f until at least min_time has passed, returns the cost of one call in ns
+template<typename F>
+double measure(F&& f) {
+  using clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds const min_time = std::chrono::milliseconds(100);
+  size_t iterations = 1;
+  for (;;) {
+    auto start = clock::now();
+    for (size_t i = 0; i != iterations; ++i)
+      f();
+    auto elapsed = clock::now() - start;
+    if (elapsed >= min_time)
+      return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    iterations *= 2;
+  }
+}
+
+template<typename Vector, typename T>
+Vector make(size_t n, T (*value)(size_t)) {
+  Vector v;
+  for (size_t i = 0; i != n; ++i)
+    v.push_back(value(i));
+  return v;
+}
+
+size_t number(size_t i) {
+  return i;
+}
+
+std::string text(size_t i) {
+  return "element number " + std::to_string(i);
+}
+
+template<typename T>
+void run_insert(char const* type, T (*value)(size_t)) {
+  for (size_t n : {100, 10000, 1000000}) {
+    size_t k = n / 10;
+    vector<T> const base = make<vector<T>>(n, value);
+    std::vector<T> const std_base = make<std::vector<T>>(n, value);
+    std::vector<T> const source = make<std::vector<T>>(k, value);
+
+    double range = measure([&] {
+      vector<T> v = base;
+      v.insert(v.begin() + n / 2, source.begin(), source.end());
+      do_not_optimize(v);
+    });
+    double std_range = measure([&] {
+      std::vector<T> v = std_base;
+      v.insert(v.begin() + n / 2, source.begin(), source.end());
+      do_not_optimize(v);
+    });
+    double fill = measure([&] {
+      vector<T> v = base;
+      v.insert(v.begin() + n / 2, k, source[0]);
+      do_not_optimize(v);
+    });
+    double std_fill = measure([&] {
+      std::vector<T> v = std_base;
+      v.insert(v.begin() + n / 2, k, source[0]);
+      do_not_optimize(v);
+    });
+    std::printf("%-12s %9zu %8zu %14.0f %14.0f %14.0f %14.0f\n", type, n, k, range, std_range, fill, std_fill);
+  }
+}
+
+template<typename Growth, typename T>
+void run_growth(char const* policy, char const* type, T (*value)(size_t), std::vector<size_t> const& sizes) {
+  for (size_t n : sizes) {
+    size_t capacity = 0;
+    double ns = measure([&] {
+      vector<T, std::allocator<T>, Growth> v;
+      for (size_t i = 0; i != n; ++i)
+        v.push_back(value(i));
+      capacity = v.capacity();
+      do_not_optimize(v);
+    });
+    std::printf("%-14s %-12s %9zu %14.2f %9.1f%%\n", policy, type, n, ns / n, 100.0 * (capacity - n) / capacity);
+  }
+}
+
+template<typename Growth>
+void run_growth(char const* policy) {
+  run_growth<Growth, size_t>(policy, "size_t", number, {1000, 100000, 10000000});
+  run_growth<Growth, std::string>(policy, "std::string", text, {1000, 100000});
+}
+}
+
+int main() {
+  std::printf("%-12s %9s %8s %14s %14s %14s %14s\n", "type", "size", "inserted", "range ns", "std range ns",
+              "fill ns", "std fill ns");
+  run_insert<size_t>("size_t", number);
+  run_insert<std::string>("std::string", text);
+
+  std::printf("\n%-14s %-12s %9s %14s %10s\n", "growth", "type", "size", "ns/push_back", "unused");
+  run_growth<growth_factor_2>("2");
+  run_growth<growth_factor_1_5>("1.5");
+  run_growth<growth_golden>("golden");
+  run_growth<growth_page_rounded<>>("1.5 paged");
+  return 0;
+}